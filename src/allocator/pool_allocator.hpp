@@ -0,0 +1,160 @@
+/*
+ * @name: pool_allocator.hpp
+ * @namespace: ubn
+ * @class: block_pool, pool_allocator
+ * @brief: Thread-caching fixed-block pool and the std allocator adaptor on top of it
+ * @author Unbinilium
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <new>
+#include <mutex>
+
+#include <array>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include <bit>
+#include <cstddef>
+
+namespace ubn {
+    /*
+     * @brief: Process wide pool of fixed size blocks, sizes are rounded up to power of two size classes
+     *         - every thread keeps a free list per size class, allocation and deallocation on it take no lock
+     *         - overflowing thread caches spill a batch to a shared shelf per size class, empty caches refill a batch from it
+     *         - chunks carved from the system allocator are never returned to it, blocks are reused instead
+     *         - requests larger than max_block_size bypass the pool
+     */
+    class block_pool {
+    public:
+        static constexpr std::size_t min_block_size { 64 };
+        static constexpr std::size_t max_block_size { 64 * 1024 };
+
+        [[nodiscard]] inline static void* allocate(const std::size_t size, const std::size_t alignment = alignof(std::max_align_t)) {
+            auto const block_size_ { block_size(size, alignment) };
+            if (block_size_ > max_block_size) return ::operator new(size, std::align_val_t { alignment });
+
+            auto&  cache_ { local_cache() };
+            auto const i_ { index(block_size_) };
+            if (!cache_.m_heads[i_]) refill(cache_, i_);
+
+            auto* block_ { std::exchange(cache_.m_heads[i_], cache_.m_heads[i_]->p_next) };
+            --cache_.m_counts[i_];
+
+            return block_;
+        }
+
+        inline static void deallocate(void* p, const std::size_t size, const std::size_t alignment = alignof(std::max_align_t)) noexcept {
+            auto const block_size_ { block_size(size, alignment) };
+            if (block_size_ > max_block_size) return ::operator delete(p, std::align_val_t { alignment });
+
+            auto&  cache_ { local_cache() };
+            auto const i_ { index(block_size_) };
+            cache_.m_heads[i_] = new (p) block { cache_.m_heads[i_] };
+            if (++cache_.m_counts[i_] > 2 * batch(i_)) spill(cache_, i_, batch(i_));
+        }
+
+    protected:
+        struct block { block* p_next; };
+
+        static constexpr std::size_t m_classes { std::countr_zero(max_block_size) - std::countr_zero(min_block_size) + 1 };
+
+        struct shelf {
+            std::mutex m_mutex;
+            block*     p_head  { nullptr };
+        };
+
+        struct cache {
+            inline ~cache(void) noexcept { for (std::size_t i { 0 }; i != m_classes; ++i) spill(*this, i, m_counts[i]); }
+
+            std::array<block*,      m_classes> m_heads  {};
+            std::array<std::size_t, m_classes> m_counts {};
+        };
+
+        constexpr static std::size_t block_size(const std::size_t size, const std::size_t alignment) noexcept {
+            return std::bit_ceil(std::max({ size, alignment, min_block_size }));
+        }
+
+        constexpr static std::size_t index(const std::size_t block_size) noexcept {
+            return std::countr_zero(block_size) - std::countr_zero(min_block_size);
+        }
+
+        constexpr static std::size_t batch(const std::size_t i) noexcept {
+            return std::max<std::size_t>(4, (max_block_size / min_block_size) >> i);
+        }
+
+        inline static cache& local_cache(void) noexcept {
+            static thread_local cache s_cache;
+            return s_cache;
+        }
+
+        inline static void refill(cache& cache_, const std::size_t i) {
+            auto& shelf_ { shelf_at(i) };
+            {
+                std::lock_guard<std::mutex> lock_(shelf_.m_mutex);
+                for (std::size_t n { 0 }; n != batch(i) && shelf_.p_head; ++n) {
+                    auto* block_ { std::exchange(shelf_.p_head, shelf_.p_head->p_next) };
+                    block_->p_next    = cache_.m_heads[i];
+                    cache_.m_heads[i] = block_;
+                    ++cache_.m_counts[i];
+                }
+            }
+            if (cache_.m_heads[i]) return;
+
+            auto const block_size_ { min_block_size << i };
+            auto*      chunk_      { static_cast<std::byte*>(::operator new(batch(i) * block_size_, std::align_val_t { block_size_ })) };
+            for (std::size_t n { 0 }; n != batch(i); ++n) cache_.m_heads[i] = new (chunk_ + n * block_size_) block { cache_.m_heads[i] };
+            cache_.m_counts[i] += batch(i);
+        }
+
+        inline static void spill(cache& cache_, const std::size_t i, std::size_t n) noexcept {
+            if (!n) return;
+
+            auto& shelf_ { shelf_at(i) };
+            std::lock_guard<std::mutex> lock_(shelf_.m_mutex);
+            for (; n && cache_.m_heads[i]; --n) {
+                auto* block_ { std::exchange(cache_.m_heads[i], cache_.m_heads[i]->p_next) };
+                block_->p_next = shelf_.p_head;
+                shelf_.p_head  = block_;
+                --cache_.m_counts[i];
+            }
+        }
+
+        inline static shelf& shelf_at(const std::size_t i) noexcept {
+            static std::array<shelf, m_classes> s_shelves;
+            return s_shelves[i];
+        }
+    };
+
+    /*
+     * @brief: Stateless std allocator backed by ubn::block_pool, every instance compares equal
+     * @param: typename, the value type to allocate
+     */
+    template <typename T>
+    struct pool_allocator {
+    public:
+        using value_type                             = T;
+        using is_always_equal                        = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+
+        constexpr pool_allocator(void) noexcept = default;
+
+        template <typename U>
+        constexpr pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        [[nodiscard]] inline T* allocate(const std::size_t n) {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+            return static_cast<T*>(block_pool::allocate(n * sizeof(T), alignof(T)));
+        }
+
+        inline void deallocate(T* p, const std::size_t n) noexcept { block_pool::deallocate(p, n * sizeof(T), alignof(T)); }
+
+        template <typename U>
+        constexpr bool operator==(const pool_allocator<U>&) const noexcept { return true; }
+    };
+}
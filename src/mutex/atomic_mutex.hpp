@@ -1,59 +1,399 @@
 #pragma once
 
+#include <array>
+#include <deque>
+#include <vector>
 #include <atomic>
+#include <cstring>
+#include <concepts>
+#include <functional>
+#include <cstdint>
 #include <cstddef>
+#include <type_traits>
+
+#include "../utilities/interference_size.hpp"
+#include "../utilities/wait_strategy.hpp"
 
 namespace ubn
 {
-    
-#ifdef __cpp_lib_hardware_interference_size
-    using std::hardware_constructive_interference_size;
-#else
-    static constexpr std::size_t hardware_constructive_interference_size{2 * sizeof(std::max_align_t)};
-#endif
-    
-    struct spin_mutex
+    /*
+     * Test and set lock with an adaptive wait, spin with backoff first and park in std::atomic::wait only once the backoff is spent
+     *  - the state is 0 unlocked, 1 locked, 2 locked with a parked waiter, unlock() only calls notify when a waiter has parked
+     */
+    template <typename Backoff = backoff<>>
+    struct basic_spin_mutex
     {
     public:
-        inline void lock(void)
+        inline void lock(void) noexcept
+        {
+            Backoff backoff_;
+            do
+            {
+                if (m_state.load(std::memory_order::relaxed) == s_unlocked && try_lock())
+                    return;
+            } while (backoff_.spin());
+
+            while (m_state.exchange(s_parked, std::memory_order::acquire) != s_unlocked)
+                m_state.wait(s_parked, std::memory_order::relaxed);
+        }
+
+        inline bool try_lock(void) noexcept
         {
-            while (m_flag.test_and_set(std::memory_order::acquire))
-                m_flag.wait(true, std::memory_order::relaxed);
+            auto unlocked_{s_unlocked};
+            return m_state.compare_exchange_strong(unlocked_, s_locked, std::memory_order::acquire, std::memory_order::relaxed);
         }
 
-        inline void unlock(void)
+        inline void unlock(void) noexcept
         {
-            m_flag.clear(std::memory_order::release);
-            m_flag.notify_one();
+            if (m_state.exchange(s_unlocked, std::memory_order::release) == s_parked)
+                m_state.notify_one();
         }
 
     private:
-        alignas(hardware_constructive_interference_size) std::atomic_flag m_flag{ATOMIC_FLAG_INIT};
+        static constexpr std::uint32_t s_unlocked{0};
+        static constexpr std::uint32_t s_locked{1};
+        static constexpr std::uint32_t s_parked{2};
+
+        alignas(hardware_destructive_interference_size) std::atomic<std::uint32_t> m_state{s_unlocked};
     };
 
-    struct ticket_mutex
+    /*
+     * Ticket lock with an adaptive wait, FIFO fair
+     *  - the waiter next in line spins with backoff on m_out first, then parks on the wake slot of its ticket, the others park directly
+     *  - unlock() bumps and notifies only the slot of the next ticket, so one waiter wakes instead of every parked one,
+     *    tickets Slots apart share a slot and may wake spuriously
+     */
+    template <typename Backoff = backoff<>, std::size_t Slots = 16>
+    struct basic_ticket_mutex
     {
+        static_assert(Slots && !(Slots & (Slots - 1)), "Slots must be a power of two");
+
     public:
-        inline void lock(void)
+        inline void lock(void) noexcept
         {
-            auto const ticket_{m_in.fetch_add(1, std::memory_order::acquire)};
+            auto const ticket_{m_in.fetch_add(1, std::memory_order::relaxed)};
+            Backoff backoff_;
+            do
+            {
+                auto const out_{m_out.load(std::memory_order::acquire)};
+                if (out_ == ticket_)
+                    return;
+                if (ticket_ - out_ > 1)
+                    break;
+            } while (backoff_.spin());
+
+            auto &slot_{m_slots[ticket_ & (Slots - 1)]};
             while (true)
             {
-                auto const now_{m_out.load(std::memory_order::acquire)};
-                if (now_ == ticket_)
+                auto const round_{slot_.load(std::memory_order::acquire)};
+                if (m_out.load(std::memory_order::acquire) == ticket_)
+                    return;
+                slot_.wait(round_, std::memory_order::relaxed);
+            }
+        }
+
+        inline bool try_lock(void) noexcept
+        {
+            auto out_{m_out.load(std::memory_order::acquire)};
+            return m_in.compare_exchange_strong(out_, out_ + 1, std::memory_order::acquire, std::memory_order::relaxed);
+        }
+
+        inline void unlock(void) noexcept
+        {
+            auto const next_{m_out.load(std::memory_order::relaxed) + 1};
+            m_out.store(next_, std::memory_order::release);
+
+            auto &slot_{m_slots[next_ & (Slots - 1)]};
+            slot_.fetch_add(1, std::memory_order::release);
+            slot_.notify_all();
+        }
+
+        /* @brief: Tickets taken and not yet served, the holder included, a racy snapshot for profiling */
+        inline std::size_t queued(void) const noexcept
+        {
+            return m_in.load(std::memory_order::relaxed) - m_out.load(std::memory_order::relaxed);
+        }
+
+    private:
+        alignas(hardware_destructive_interference_size) std::atomic<std::size_t> m_in{0};
+        alignas(hardware_destructive_interference_size) std::atomic<std::size_t> m_out{0};
+        alignas(hardware_destructive_interference_size) std::array<std::atomic<std::uint32_t>, Slots> m_slots{};
+    };
+
+    /*
+     * MCS queue lock, FIFO fair, every waiter spins on its own node instead of a shared cache line
+     *  - nodes come from a thread local pool, so lock() and unlock() need no node argument and work with std::lock_guard
+     *  - every waiter spins with backoff on its own flag and parks on it only once the backoff is spent
+     *  - unlock() hands over by clearing the flag of the next node only
+     *  - a thread must not exit while it holds the lock, its node pool goes with it
+     */
+    template <typename Backoff = backoff<>>
+    struct basic_mcs_mutex
+    {
+    public:
+        inline void lock(void) noexcept
+        {
+            auto *node_{acquire_node()};
+            if (auto *prev_{m_tail.exchange(node_, std::memory_order::acq_rel)})
+            {
+                node_->m_locked_.store(1, std::memory_order::relaxed);
+                prev_->m_next_.store(node_, std::memory_order::release);
+
+                Backoff backoff_;
+                while (node_->m_locked_.load(std::memory_order::acquire))
+                    if (!backoff_.spin())
+                        node_->m_locked_.wait(1, std::memory_order::acquire);
+            }
+            m_owner = node_;
+        }
+
+        inline bool try_lock(void) noexcept
+        {
+            auto *node_{acquire_node()};
+            node_t *tail_{nullptr};
+            if (!m_tail.compare_exchange_strong(tail_, node_, std::memory_order::acquire, std::memory_order::relaxed))
+            {
+                release_node(node_);
+                return false;
+            }
+            m_owner = node_;
+
+            return true;
+        }
+
+        inline void unlock(void) noexcept
+        {
+            auto *node_{m_owner};
+            auto *next_{node_->m_next_.load(std::memory_order::acquire)};
+            if (!next_)
+            {
+                auto *tail_{node_};
+                if (m_tail.compare_exchange_strong(tail_, nullptr, std::memory_order::release, std::memory_order::relaxed))
+                {
+                    release_node(node_);
                     return;
-                m_out.wait(now_, std::memory_order::relaxed);
+                }
+                while (!(next_ = node_->m_next_.load(std::memory_order::acquire)))
+                    cpu_relax();
             }
+
+            next_->m_locked_.store(0, std::memory_order::release);
+            next_->m_locked_.notify_one();
+            release_node(node_);
         }
 
-        inline void unlock(void)
+    protected:
+        struct alignas(hardware_destructive_interference_size) node_t
+        {
+            std::atomic<node_t *> m_next_{nullptr};
+            std::atomic<std::uint32_t> m_locked_{0};
+        };
+
+        struct pool_t
+        {
+            std::deque<node_t> m_nodes_;
+            std::vector<node_t *> m_free_;
+        };
+
+        inline static node_t *acquire_node(void) noexcept
         {
-            m_out.fetch_add(1, std::memory_order::release);
-            m_out.notify_all();
+            auto &pool_{pool()};
+            if (pool_.m_free_.empty())
+                return &pool_.m_nodes_.emplace_back();
+
+            auto *node_{pool_.m_free_.back()};
+            pool_.m_free_.pop_back();
+            node_->m_next_.store(nullptr, std::memory_order::relaxed);
+
+            return node_;
+        }
+
+        inline static void release_node(node_t *node_) noexcept { pool().m_free_.push_back(node_); }
+
+        inline static pool_t &pool(void) noexcept
+        {
+            thread_local pool_t pool_;
+            return pool_;
         }
 
     private:
-        alignas(hardware_constructive_interference_size) std::atomic<std::size_t> m_in{ATOMIC_VAR_INIT(0)};
-        alignas(hardware_constructive_interference_size) std::atomic<std::size_t> m_out{ATOMIC_VAR_INIT(0)};
+        alignas(hardware_destructive_interference_size) std::atomic<node_t *> m_tail{nullptr};
+        node_t *m_owner{nullptr};
     };
+
+    /*
+     * Reader writer spin lock with writer preference, SharedLockable so it works with std::shared_lock and std::lock_guard
+     *  - one state word, readers in the low 16 bits, waiting writers in bits 16 to 30, the holding writer in bit 31
+     *  - the reader count saturates at 0xffff, a further reader waits like it would for a writer until one of them unlocks
+     *  - a waiting writer stops new readers from entering, so a steady stream of readers cannot starve it
+     *  - waiters spin with backoff first, then park on the state word
+     */
+    template <typename Backoff = backoff<>>
+    struct basic_rw_spin_mutex
+    {
+    public:
+        inline void lock(void) noexcept
+        {
+            m_state.fetch_add(s_pending, std::memory_order::relaxed);
+            acquire([](const std::uint32_t state_) { return !(state_ & (s_writer | s_readers)); },
+                    [](const std::uint32_t state_) { return (state_ - s_pending) | s_writer; });
+        }
+
+        inline bool try_lock(void) noexcept
+        {
+            auto state_{m_state.load(std::memory_order::relaxed)};
+            return !(state_ & (s_writer | s_readers)) &&
+                   m_state.compare_exchange_strong(state_, state_ | s_writer, std::memory_order::acquire, std::memory_order::relaxed);
+        }
+
+        inline void unlock(void) noexcept
+        {
+            m_state.fetch_and(~s_writer, std::memory_order::release);
+            m_state.notify_all();
+        }
+
+        inline void lock_shared(void) noexcept
+        {
+            acquire([](const std::uint32_t state_) { return !(state_ & (s_writer | s_pendings)) && (state_ & s_readers) != s_readers; },
+                    [](const std::uint32_t state_) { return state_ + 1; });
+        }
+
+        inline bool try_lock_shared(void) noexcept
+        {
+            auto state_{m_state.load(std::memory_order::relaxed)};
+            return !(state_ & (s_writer | s_pendings)) && (state_ & s_readers) != s_readers &&
+                   m_state.compare_exchange_strong(state_, state_ + 1, std::memory_order::acquire, std::memory_order::relaxed);
+        }
+
+        inline void unlock_shared(void) noexcept
+        {
+            auto const state_{m_state.fetch_sub(1, std::memory_order::release)};
+            if (((state_ & s_readers) == 1 && (state_ & s_pendings)) || (state_ & s_readers) == s_readers)
+                m_state.notify_all();
+        }
+
+    protected:
+        template <typename Ready, typename Next>
+        inline void acquire(Ready &&ready_, Next &&next_) noexcept
+        {
+            Backoff backoff_;
+            for (auto state_{m_state.load(std::memory_order::relaxed)};;)
+            {
+                if (ready_(state_))
+                {
+                    if (m_state.compare_exchange_weak(state_, next_(state_), std::memory_order::acquire, std::memory_order::relaxed))
+                        return;
+                    continue;
+                }
+                if (!backoff_.spin())
+                    m_state.wait(state_, std::memory_order::relaxed);
+                state_ = m_state.load(std::memory_order::relaxed);
+            }
+        }
+
+    private:
+        static constexpr std::uint32_t s_readers{0x0000ffff};
+        static constexpr std::uint32_t s_pending{0x00010000};
+        static constexpr std::uint32_t s_pendings{0x7fff0000};
+        static constexpr std::uint32_t s_writer{0x80000000};
+
+        alignas(hardware_destructive_interference_size) std::atomic<std::uint32_t> m_state{0};
+    };
+
+    /*
+     * Sequence lock around a trivially copyable snapshot, for read-mostly data like config or the latest results
+     *  - load() never blocks a writer, it copies the value and retries while a store() overlapped the copy
+     *  - the value is kept in relaxed atomic words, so the racing copy is well defined, stores are serialized on the sequence
+     *  - readers are optimistic and retry, there is no shared lock to hold, use ubn::rw_spin_mutex where a std::shared_lock is needed
+     */
+    template <typename T>
+        requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+    class seqlock
+    {
+    public:
+        inline explicit seqlock(const T &v = T{}) noexcept { write_words(v); }
+
+        inline seqlock(const seqlock &) = delete;
+        inline seqlock &operator=(const seqlock &) = delete;
+
+        inline T load(void) const noexcept
+        {
+            while (true)
+            {
+                auto const before_{m_sequence.load(std::memory_order::acquire)};
+                if (before_ & 1)
+                {
+                    cpu_relax();
+                    continue;
+                }
+
+                auto const v_{read_words()};
+                std::atomic_thread_fence(std::memory_order::acquire);
+                if (m_sequence.load(std::memory_order::relaxed) == before_)
+                    return v_;
+            }
+        }
+
+        inline void store(const T &v) noexcept
+        {
+            update([&v](T &value_) { value_ = v; });
+        }
+
+        /*
+         * @brief: Read, modify and publish the value, concurrent writers are serialized
+         * @param: F&&, invocable with T&, a copy of the current value
+         */
+        template <std::invocable<T &> F>
+        inline void update(F &&f) noexcept
+        {
+            auto sequence_{m_sequence.load(std::memory_order::relaxed)};
+            for (backoff<> backoff_;; sequence_ = m_sequence.load(std::memory_order::relaxed))
+            {
+                if (!(sequence_ & 1) && m_sequence.compare_exchange_weak(sequence_, sequence_ + 1, std::memory_order::acquire, std::memory_order::relaxed))
+                    break;
+                if (!backoff_.spin())
+                    std::this_thread::yield();
+            }
+            // acquire pairs with the previous writer's release store, the release fence keeps the odd sequence ahead of the new words
+            std::atomic_thread_fence(std::memory_order::release);
+
+            auto v_{read_words()};
+            std::invoke(std::forward<F>(f), v_);
+            write_words(v_);
+
+            m_sequence.store(sequence_ + 2, std::memory_order::release);
+        }
+
+    protected:
+        inline T read_words(void) const noexcept
+        {
+            std::array<std::size_t, s_words> words_;
+            for (std::size_t i{0}; i != s_words; ++i)
+                words_[i] = m_words[i].load(std::memory_order::relaxed);
+
+            T v_;
+            std::memcpy(&v_, words_.data(), sizeof(T));
+
+            return v_;
+        }
+
+        inline void write_words(const T &v) noexcept
+        {
+            std::array<std::size_t, s_words> words_{};
+            std::memcpy(words_.data(), &v, sizeof(T));
+            for (std::size_t i{0}; i != s_words; ++i)
+                m_words[i].store(words_[i], std::memory_order::relaxed);
+        }
+
+    private:
+        static constexpr std::size_t s_words{(sizeof(T) + sizeof(std::size_t) - 1) / sizeof(std::size_t)};
+
+        alignas(hardware_destructive_interference_size) std::atomic<std::size_t> m_sequence{0};
+        std::array<std::atomic<std::size_t>, s_words> m_words{};
+    };
+
+    using spin_mutex = basic_spin_mutex<>;
+    using ticket_mutex = basic_ticket_mutex<>;
+    using mcs_mutex = basic_mcs_mutex<>;
+    using rw_spin_mutex = basic_rw_spin_mutex<>;
 }
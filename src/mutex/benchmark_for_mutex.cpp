@@ -0,0 +1,102 @@
+/*
+ Note:
+    - compares ubn::spin_mutex, ubn::ticket_mutex, ubn::mcs_mutex and std::mutex under contention
+    - sweeps the thread count from 1 to the given maximum, doubling, each thread takes the lock a fixed number of times
+    - the critical section bumps a few shared counters, the threads do a little private work between two acquisitions
+    - reports acquisitions per second, ns per acquisition, the spread between the fastest and the slowest thread (fairness)
+      and context switches (voluntary + involuntary)
+    - usage: ./<binary> [acquisitions per thread, default 100000] [max threads, default hardware concurrency]
+ */
+
+#include "atomic_mutex.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <mutex>
+#include <array>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+
+#include <sys/resource.h>
+
+using clock_type = std::chrono::steady_clock;
+
+struct result {
+    double m_throughput;
+    double m_ns_per_lock;
+    double m_spread;
+    long   m_context_switches;
+};
+
+static inline long context_switches(void) {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+template <typename M>
+static inline result run(const std::size_t threads, const std::size_t acquisitions) {
+    M                                     m;
+    std::array<std::size_t, 4>            shared_ {};
+    std::vector<double>                   elapsed_(threads);
+    std::vector<std::thread>              threads_;
+    std::atomic_bool                      start_ { false };
+
+    auto const switches_ { context_switches() };
+    for (std::size_t t { 0 }; t != threads; ++t) {
+        threads_.emplace_back([&, t] {
+            std::size_t private_ { t };
+            start_.wait(false);
+            auto const begin_ { clock_type::now() };
+            for (std::size_t i { 0 }; i != acquisitions; ++i) {
+                {
+                    std::lock_guard lock_ { m };
+                    for (auto& v : shared_) v += private_;
+                }
+                for (std::size_t j { 0 }; j != 32; ++j) private_ = private_ * 6364136223846793005ull + 1442695040888963407ull;
+            }
+            elapsed_[t] = std::chrono::duration<double>(clock_type::now() - begin_).count();
+        });
+    }
+
+    auto const begin_ { clock_type::now() };
+    start_.store(true);
+    start_.notify_all();
+    for (auto& thread : threads_) thread.join();
+    auto const seconds_ { std::chrono::duration<double>(clock_type::now() - begin_).count() };
+
+    auto const [min_, max_] { std::minmax_element(elapsed_.begin(), elapsed_.end()) };
+    auto const total_ { static_cast<double>(threads * acquisitions) };
+
+    return {
+        total_ / seconds_,
+        seconds_ * 1e9 / total_,
+        *min_ > 0 ? *max_ / *min_ : 0,
+        context_switches() - switches_
+    };
+}
+
+static inline void report(const char* name, const std::size_t threads, const result& r) {
+    std::printf("%-14s %7zu %14.0f %10.1f %8.2f %10ld\n", name, threads, r.m_throughput, r.m_ns_per_lock, r.m_spread, r.m_context_switches);
+}
+
+int main(int argc, char** argv) {
+    const std::size_t acquisitions { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000 };
+    const std::size_t max_threads  { argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency()) };
+
+    std::printf("%-14s %7s %14s %10s %8s %10s\n", "mutex", "threads", "locks/s", "ns/lock", "spread", "ctx-sw");
+
+    for (std::size_t n { 1 }; n <= max_threads; n = n < max_threads && n * 2 > max_threads ? max_threads : n * 2) {
+        report("spin_mutex",   n, run<ubn::spin_mutex>  (n, acquisitions));
+        report("ticket_mutex", n, run<ubn::ticket_mutex>(n, acquisitions));
+        report("mcs_mutex",    n, run<ubn::mcs_mutex>   (n, acquisitions));
+        report("std::mutex",   n, run<std::mutex>       (n, acquisitions));
+        if (n == max_threads) break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <source_location>
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+namespace ubn
+{
+    /*
+     * Contention counters of one lock site, shared by every profiled_mutex constructed at the same source location
+     */
+    struct lock_site
+    {
+        std::string m_file;
+        std::string m_function;
+        std::uint_least32_t m_line{0};
+
+        std::atomic_uint64_t m_locks{0};
+        std::atomic_uint64_t m_contended{0};
+        std::atomic_uint64_t m_wait_ns{0};
+        std::atomic_uint64_t m_wait_max_ns{0};
+        std::atomic_uint64_t m_hold_ns{0};
+        std::atomic_uint64_t m_hold_max_ns{0};
+        std::atomic_size_t m_max_depth{0};
+
+        template <typename A>
+        inline static void raise(A &max_, const typename A::value_type v_) noexcept
+        {
+            for (auto now_{max_.load(std::memory_order::relaxed)}; v_ > now_ && !max_.compare_exchange_weak(now_, v_, std::memory_order::relaxed);)
+            {
+            }
+        }
+    };
+
+    /*
+     * Registry of lock sites, prints a report sorted by total wait time on demand and at exit
+     *  - sites are never removed, a profiled_mutex only keeps a pointer to its site
+     */
+    class lock_profiler
+    {
+    public:
+        inline static lock_profiler &instance(void)
+        {
+            static lock_profiler profiler_;
+            return profiler_;
+        }
+
+        inline ~lock_profiler(void) noexcept
+        {
+            if (m_report_at_exit)
+                report();
+        }
+
+        inline lock_site &site(const std::source_location &location)
+        {
+            std::lock_guard lock_{m_lock};
+            for (auto &site_ : m_sites)
+                if (site_->m_line == location.line() && site_->m_file == location.file_name())
+                    return *site_;
+
+            auto &site_{*m_sites.emplace_back(std::make_unique<lock_site>())};
+            site_.m_file = location.file_name();
+            site_.m_function = location.function_name();
+            site_.m_line = location.line();
+
+            return site_;
+        }
+
+        /* @brief: Print every site, the most waited on first, max depth is only sampled for ubn::ticket_mutex */
+        inline void report(std::FILE *out = stderr) const
+        {
+            std::lock_guard lock_{m_lock};
+            std::vector<const lock_site *> sites_;
+            for (auto const &site_ : m_sites)
+                sites_.push_back(site_.get());
+            std::sort(sites_.begin(), sites_.end(), [](auto *a_, auto *b_)
+                      { return a_->m_wait_ns.load(std::memory_order::relaxed) > b_->m_wait_ns.load(std::memory_order::relaxed); });
+
+            std::fprintf(out, "%-40s %12s %10s %12s %12s %12s %12s %6s\n",
+                         "site", "locks", "contended", "wait(ms)", "wait max(us)", "hold(ms)", "hold max(us)", "depth");
+            for (auto const *site_ : sites_)
+            {
+                auto const locks_{site_->m_locks.load(std::memory_order::relaxed)};
+                auto const location_{site_->m_file.substr(site_->m_file.find_last_of('/') + 1) + ":" + std::to_string(site_->m_line)};
+                std::fprintf(out, "%-40s %12llu %9.1f%% %12.3f %12.3f %12.3f %12.3f %6zu\n",
+                             location_.c_str(),
+                             static_cast<unsigned long long>(locks_),
+                             locks_ ? 100.0 * site_->m_contended.load(std::memory_order::relaxed) / locks_ : 0.0,
+                             site_->m_wait_ns.load(std::memory_order::relaxed) / 1e6,
+                             site_->m_wait_max_ns.load(std::memory_order::relaxed) / 1e3,
+                             site_->m_hold_ns.load(std::memory_order::relaxed) / 1e6,
+                             site_->m_hold_max_ns.load(std::memory_order::relaxed) / 1e3,
+                             site_->m_max_depth.load(std::memory_order::relaxed));
+            }
+        }
+
+        inline void report_at_exit(const bool enable) noexcept { m_report_at_exit = enable; }
+
+    protected:
+        inline lock_profiler(void) = default;
+
+    private:
+        mutable std::mutex m_lock;
+        std::vector<std::unique_ptr<lock_site>> m_sites;
+        bool m_report_at_exit{true};
+    };
+
+    /*
+     * Instrumented wrapper around a Lockable, the site is the source location the wrapper is constructed at
+     *  - records acquisitions, contended acquisitions, wait time and hold time, plus the ticket queue depth for ubn::ticket_mutex
+     *  - a failed try_lock() first is what counts as contended, so the uncontended path costs a try_lock and two clock reads
+     *  - define UBN_LOCK_PROFILING to turn ubn::maybe_profiled<M> into profiled_mutex<M>, it is plain M otherwise
+     */
+    template <typename M>
+    class profiled_mutex
+    {
+    public:
+        inline explicit profiled_mutex(const std::source_location location = std::source_location::current())
+            : p_site{&lock_profiler::instance().site(location)} {}
+
+        inline profiled_mutex(const profiled_mutex &) = delete;
+        inline profiled_mutex &operator=(const profiled_mutex &) = delete;
+
+        inline void lock(void)
+        {
+            if constexpr (requires(const M &m_) { m_.queued(); })
+                lock_site::raise(p_site->m_max_depth, m_mutex.queued() + 1);
+
+            if (!m_mutex.try_lock())
+            {
+                auto const begin_{clock_type::now()};
+                m_mutex.lock();
+                auto const wait_{elapsed(begin_)};
+
+                p_site->m_contended.fetch_add(1, std::memory_order::relaxed);
+                p_site->m_wait_ns.fetch_add(wait_, std::memory_order::relaxed);
+                lock_site::raise(p_site->m_wait_max_ns, wait_);
+            }
+            acquired();
+        }
+
+        inline bool try_lock(void)
+        {
+            if (!m_mutex.try_lock())
+                return false;
+            acquired();
+
+            return true;
+        }
+
+        inline void unlock(void)
+        {
+            auto const hold_{elapsed(m_since)};
+            m_mutex.unlock();
+
+            p_site->m_hold_ns.fetch_add(hold_, std::memory_order::relaxed);
+            lock_site::raise(p_site->m_hold_max_ns, hold_);
+        }
+
+        inline const lock_site &site(void) const noexcept { return *p_site; }
+
+    protected:
+        using clock_type = std::chrono::steady_clock;
+
+        inline static std::uint64_t elapsed(const clock_type::time_point since_) noexcept
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - since_).count());
+        }
+
+        inline void acquired(void) noexcept
+        {
+            p_site->m_locks.fetch_add(1, std::memory_order::relaxed);
+            m_since = clock_type::now();
+        }
+
+    private:
+        M m_mutex;
+        lock_site *p_site;
+        clock_type::time_point m_since;
+    };
+
+#ifdef UBN_LOCK_PROFILING
+    template <typename M>
+    using maybe_profiled = profiled_mutex<M>;
+#else
+    template <typename M>
+    using maybe_profiled = M;
+#endif
+}
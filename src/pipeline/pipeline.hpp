@@ -0,0 +1,295 @@
+/*
+ * @name: pipeline.hpp
+ * @namespace: ubn
+ * @class: pipeline
+ * @brief: Typed multi-stage pipeline, bounded ticket queues between stages, per-stage threads and latency stats
+ * @author Unbinilium
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <deque>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include <cstdint>
+#include <cstddef>
+
+#include <concepts>
+#include <optional>
+
+#include "../queue/atomic_queue_limited.hpp"
+#include "reorder_buffer.hpp"
+
+namespace ubn {
+    /* @brief: Latency of one stage, busy time is the time spent inside the stage callable summed over its threads */
+    struct stage_stats {
+        std::string              m_name;
+        std::size_t              m_threads;
+        std::uint64_t            m_items;
+        std::chrono::nanoseconds m_busy;
+        std::chrono::nanoseconds m_max;
+
+        inline std::chrono::nanoseconds mean(void) const noexcept { return m_items ? m_busy / static_cast<std::int64_t>(m_items) : std::chrono::nanoseconds { 0 }; }
+    };
+
+    /* @brief: State shared by every pipeline<In, Out> of one chain, the edges, stage threads and their records */
+    class pipeline_base {
+    protected:
+        template <typename T>
+        struct sequenced {
+            std::size_t m_sequence;
+            T           m_value;
+        };
+
+        template <typename T>
+        using edge = atomic_limited::queue<sequenced<T>>;
+
+        struct record {
+            inline record(std::string name, const std::size_t threads) : m_name_ { std::move(name) }, m_threads_ { threads }, m_live_ { threads } {}
+
+            inline void done(const std::chrono::nanoseconds elapsed) noexcept {
+                auto const ns_ { static_cast<std::uint64_t>(elapsed.count()) };
+                m_items_.fetch_add(1, std::memory_order::relaxed);
+                m_busy_.fetch_add(ns_, std::memory_order::relaxed);
+                for (auto max_ { m_max_.load(std::memory_order::relaxed) }; ns_ > max_ && !m_max_.compare_exchange_weak(max_, ns_, std::memory_order::relaxed);) {}
+            }
+
+            std::string const    m_name_;
+            std::size_t const    m_threads_;
+            std::atomic_size_t   m_live_;
+            std::atomic_uint64_t m_items_ { 0 };
+            std::atomic_uint64_t m_busy_  { 0 };
+            std::atomic_uint64_t m_max_   { 0 };
+        };
+
+        /* @brief: Admission window of one reorder stage, the sequence numbers it has released so far, the top bit once it is closed */
+        struct gate {
+            inline explicit gate(const std::size_t window) : m_window_ { window } {}
+
+            inline void release(const std::size_t n) noexcept {
+                m_released_.fetch_add(n, std::memory_order::release);
+                m_released_.notify_all();
+            }
+
+            inline void close(void) noexcept {
+                m_released_.fetch_or(s_closed, std::memory_order::release);
+                m_released_.notify_all();
+            }
+
+            static constexpr std::size_t s_closed { std::size_t { 1 } << (std::numeric_limits<std::size_t>::digits - 1) };
+
+            std::size_t const  m_window_;
+            std::atomic_size_t m_released_ { 0 };
+        };
+
+        struct graph {
+            /*
+             * @brief: Close every edge and join the stages, items still in flight are dropped with the edges
+             *         - a closed edge fails pushes that wait for a full slot too, so a stage blocked on an output nobody polls returns
+             */
+            inline ~graph(void) noexcept {
+                for (auto& close_ : m_closers) close_();
+                for (auto& thread_ : m_threads) if (thread_.joinable()) thread_.join();
+            }
+
+            /* @brief: Wait until every reorder stage has room for the sequence number, false once one of them has been closed */
+            inline bool admit(const std::size_t sequence) noexcept {
+                for (auto& gate_ : m_gates) {
+                    for (auto released_ { gate_.m_released_.load(std::memory_order::acquire) }; sequence >= (released_ & ~gate::s_closed) + gate_.m_window_;
+                         released_ = gate_.m_released_.load(std::memory_order::acquire)) {
+                        if (released_ & gate::s_closed) return false;
+                        gate_.m_released_.wait(released_, std::memory_order::relaxed);
+                    }
+                }
+
+                return true;
+            }
+
+            template <typename T>
+            inline edge<T>* make_edge(const std::size_t capacity) {
+                auto edge_ { std::make_shared<edge<T>>(capacity) };
+                m_closers.emplace_back([p_ = edge_.get()] { p_->close(); });
+                m_edges.push_back(edge_);
+
+                return edge_.get();
+            }
+
+            std::vector<std::shared_ptr<void>>  m_edges;
+            std::vector<std::function<void()>>  m_closers;
+            std::deque<record>                  m_records;
+            std::deque<gate>                    m_gates;
+            std::vector<std::thread>            m_threads;
+            std::atomic_size_t                  m_sequence { 0 };
+        };
+    };
+
+    /*
+     * @brief: Chain of stages fed through bounded queues, build it by chaining rvalues and keep the last one
+     *         - stage(): each thread gets its own copy of the callable, a full output queue blocks the stage (backpressure)
+     *         - ordered(): a single thread reorder stage restores push order with ubn::reorder_buffer, unordered otherwise, push() blocks
+     *           while an item would land a window or more ahead of what the stage has released, so its buffer stays bounded
+     *         - a stage returning void is a sink, the pipeline then has no output to poll
+     *         - close() ends the input, every stage drains its queue and closes the next one, wait() joins the threads
+     * @usage: auto p { ubn::pipeline<cv::Mat> { 4 }.stage("detect", detect, 4).ordered().stage("decode", decode) };
+     */
+    template <typename In, typename Out = In>
+    class pipeline : public pipeline_base {
+        template <typename, typename>
+        friend class pipeline;
+
+    public:
+        /* @param: const std::size_t, capacity of the input queue */
+        inline explicit pipeline(const std::size_t capacity = 64) requires std::same_as<In, Out> :
+            m_graph { std::make_unique<graph>() } {
+
+            p_input  = m_graph->template make_edge<In>(capacity);
+            p_output = p_input;
+        }
+
+        inline pipeline           (pipeline&&) noexcept = default;
+        inline pipeline &operator=(pipeline&&) noexcept = default;
+
+        /*
+         * @brief:  Append a stage and start its threads
+         * @param:  std::string, the name reported by stats()
+         * @param:  F, invocable with Out&&, its result type is the input of the next stage
+         * @param:  const std::size_t, the number of threads running the stage
+         * @param:  const std::size_t, capacity of the queue after the stage
+         * @return: pipeline<In, R>, the chain extended by the stage
+         */
+        template <typename F> requires std::invocable<F&, Out&&> && std::copy_constructible<F>
+        inline auto stage(std::string name, F f, const std::size_t threads = 1, const std::size_t capacity = 64) && {
+            using R = std::invoke_result_t<F&, Out&&>;
+
+            auto const n_      { threads ? threads : 1 };
+            auto&      record_ { m_graph->m_records.emplace_back(std::move(name), n_) };
+            edge<R>*   output_ { nullptr };
+            if constexpr (!std::is_void_v<R>) output_ = m_graph->template make_edge<R>(capacity);
+
+            for (std::size_t i { 0 }; i != n_; ++i)
+                m_graph->m_threads.emplace_back([input_ = p_output, output_, &record_, f_ = f]() mutable { work(*input_, output_, f_, record_); });
+
+            return pipeline<In, R> { std::move(m_graph), p_input, output_ };
+        }
+
+        /*
+         * @brief:  Append a reorder stage, items leave it in the order they have been pushed into the pipeline
+         * @param:  const std::size_t, capacity of the queue after the stage
+         * @param:  const std::size_t, the most items pushed into the pipeline and not yet released by the stage, bounds its buffer
+         */
+        inline pipeline ordered(const std::size_t capacity = 64, const std::size_t window = 256) && requires (!std::is_void_v<Out>) {
+            auto& record_ { m_graph->m_records.emplace_back("reorder", 1) };
+            auto& gate_   { m_graph->m_gates.emplace_back(window ? window : 1) };
+            auto* output_ { m_graph->template make_edge<Out>(capacity) };
+            m_graph->m_closers.emplace_back([&gate_] { gate_.close(); });
+
+            m_graph->m_threads.emplace_back([input_ = p_output, output_, &record_, &gate_] {
+                reorder_buffer<Out> buffer_   { std::min<std::size_t>(gate_.m_window_, 64), 0, gate_.m_window_ };
+                std::size_t         sequence_ { 0 };
+                auto const          emit_     { [&](Out&& v) { output_->push(sequenced<Out> { sequence_++, std::move(v) }); } };
+
+                while (auto item_ { input_->poll() }) {
+                    auto const begin_ { std::chrono::steady_clock::now() };
+                    buffer_.insert(item_->m_sequence, std::move(item_->m_value));
+                    if (auto const n_ { buffer_.release(emit_) }) gate_.release(n_);
+                    record_.done(std::chrono::steady_clock::now() - begin_);
+                }
+                buffer_.flush(emit_);
+                gate_.close();
+                output_->close();
+            });
+
+            return pipeline { std::move(m_graph), p_input, output_ };
+        }
+
+        /*
+         * @brief:  Feed an item, blocks while the input queue is full or a reorder stage is a window behind
+         * @return: bool, false once the pipeline has been closed
+         */
+        inline bool push(std::convertible_to<In> auto&& v) {
+            auto const sequence_ { m_graph->m_sequence.fetch_add(1, std::memory_order::relaxed) };
+            if (!m_graph->admit(sequence_)) return false;
+
+            return p_input->push(sequenced<In> { sequence_, In(std::forward<decltype(v)>(v)) });
+        }
+
+        /*
+         * @brief:  Take an item from the last stage, blocks while it is empty
+         * @return: std::optional<Out>, std::nullopt once the pipeline has been closed and drained
+         */
+        inline std::optional<Out> poll(void) requires (!std::is_void_v<Out>) {
+            std::optional<Out> tmp_;
+            p_output->consume([&tmp_](sequenced<Out>&& item_) { tmp_.emplace(std::move(item_.m_value)); });
+
+            return tmp_;
+        }
+
+        template <typename U = Out> requires (!std::is_void_v<U>)
+        inline bool poll(U& out) {
+            return p_output->consume([&out](sequenced<Out>&& item_) { out = std::move(item_.m_value); });
+        }
+
+        /* @brief: End the input, the stages finish what has been pushed and shut down in order, pushes waiting on a reorder window fail */
+        inline void close(void) noexcept {
+            p_input->close();
+            for (auto& gate_ : m_graph->m_gates) gate_.close();
+        }
+
+        /* @brief: Join every stage thread, call after close() and keep polling the output meanwhile unless the last stage is a sink */
+        inline void wait(void) noexcept {
+            for (auto& thread_ : m_graph->m_threads) if (thread_.joinable()) thread_.join();
+        }
+
+        inline std::vector<stage_stats> stats(void) const {
+            std::vector<stage_stats> stats_;
+            stats_.reserve(m_graph->m_records.size());
+            for (auto const& record_ : m_graph->m_records) {
+                stats_.push_back({ record_.m_name_, record_.m_threads_, record_.m_items_.load(std::memory_order::relaxed),
+                                   std::chrono::nanoseconds { record_.m_busy_.load(std::memory_order::relaxed) },
+                                   std::chrono::nanoseconds { record_.m_max_.load(std::memory_order::relaxed) } });
+            }
+
+            return stats_;
+        }
+
+    protected:
+        inline pipeline(std::unique_ptr<graph> graph_, edge<In>* input_, edge<Out>* output_) noexcept :
+            m_graph { std::move(graph_) }, p_input { input_ }, p_output { output_ } {}
+
+        template <typename I, typename O, typename F>
+        inline static void work(edge<I>& input_, edge<O>* output_, F& f_, record& record_) {
+            while (auto item_ { input_.poll() }) {
+                auto const begin_ { std::chrono::steady_clock::now() };
+                if constexpr (std::is_void_v<O>) {
+                    std::invoke(f_, std::move(item_->m_value));
+                    record_.done(std::chrono::steady_clock::now() - begin_);
+                } else {
+                    sequenced<O> result_ { item_->m_sequence, std::invoke(f_, std::move(item_->m_value)) };
+                    record_.done(std::chrono::steady_clock::now() - begin_);
+                    if (!output_->push(std::move(result_))) break;
+                }
+            }
+
+            if (record_.m_live_.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+                if constexpr (!std::is_void_v<O>) output_->close();
+            }
+        }
+
+    private:
+        std::unique_ptr<graph> m_graph;
+        edge<In>*              p_input  { nullptr };
+        edge<Out>*             p_output { nullptr };
+    };
+}
@@ -0,0 +1,128 @@
+/*
+ * @name: reorder_buffer.hpp
+ * @namespace: ubn
+ * @class: reorder_buffer
+ * @brief: Restores sequence order of items finished out of order by parallel workers
+ * @author Unbinilium
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <functional>
+
+#include <bit>
+
+#include <cstddef>
+#include <concepts>
+
+namespace ubn {
+    /*
+     * @brief: Single threaded reorder window, the reusable form of filter() and final() in src/module/multi_threading_guide_semaphore.cpp
+     *         - insert() parks an item at its sequence number, release() hands out the contiguous run starting at next() in order
+     *         - the window is a power of two ring of std::optional, it doubles when an item arrives more than a window ahead, up to the limit
+     *         - insert() refuses an item limit or more ahead of next(), bound the items in flight upstream to stay inside it
+     */
+    template <typename T>
+    class reorder_buffer {
+    public:
+        /*
+         * @param: const std::size_t, the initial window, rounded up to a power of two
+         * @param: const std::size_t, the first sequence number to release
+         * @param: const std::size_t, how far ahead of next() an item may arrive, the window never grows past it
+         */
+        inline explicit reorder_buffer(const std::size_t window = 64, const std::size_t first = 0, const std::size_t limit = std::numeric_limits<std::size_t>::max()) :
+            m_slots ( std::bit_ceil(std::max<std::size_t>(std::min(window, limit), 1)) ),
+            m_next  { first },
+            m_limit { std::max<std::size_t>(limit, 1) } {}
+
+        /*
+         * @brief:  Park an item until every item before it has been released
+         * @param:  const std::size_t, the sequence number, must not be released already and must be unique
+         * @return: bool, false and nothing is parked if the item is limit or more ahead of next()
+         */
+        template <typename... Args>
+        inline bool insert(const std::size_t sequence, Args&&... args) {
+            if (sequence - m_next >= m_limit) return false;
+            if (sequence - m_next >= m_slots.size()) grow(sequence - m_next + 1);
+
+            m_slots[sequence & (m_slots.size() - 1)].emplace(std::forward<Args>(args)...);
+            ++m_size;
+
+            return true;
+        }
+
+        /*
+         * @brief:  Hand out every ready item from next() on, stops at the first gap
+         * @param:  F&&, invocable with T&&, called in sequence order
+         * @return: std::size_t, the number of released items
+         */
+        template <std::invocable<T&&> F>
+        inline std::size_t release(F&& f) {
+            std::size_t n_ { 0 };
+            for (auto* slot_ { &m_slots[m_next & (m_slots.size() - 1)] }; slot_->has_value(); slot_ = &m_slots[m_next & (m_slots.size() - 1)]) {
+                std::invoke(f, std::move(**slot_));
+                slot_->reset();
+                ++m_next;
+                --m_size;
+                ++n_;
+            }
+
+            return n_;
+        }
+
+        /*
+         * @brief:  Hand out every parked item in sequence order, skipping the gaps, for when the missing items will never arrive
+         * @return: std::size_t, the number of released items
+         */
+        template <std::invocable<T&&> F>
+        inline std::size_t flush(F&& f) {
+            std::size_t n_ { 0 };
+            for (; m_size; ++m_next) {
+                auto& slot_ { m_slots[m_next & (m_slots.size() - 1)] };
+                if (!slot_.has_value()) continue;
+
+                std::invoke(f, std::move(*slot_));
+                slot_.reset();
+                --m_size;
+                ++n_;
+            }
+
+            return n_;
+        }
+
+        /* @brief: The next sequence number release() waits for */
+        inline std::size_t next(void) const noexcept { return m_next; }
+
+        /* @brief: How far ahead of next() insert() accepts an item */
+        inline std::size_t limit(void) const noexcept { return m_limit; }
+
+        /* @brief: The number of parked items */
+        inline std::size_t size(void) const noexcept { return m_size; }
+
+        inline bool empty(void) const noexcept { return !m_size; }
+
+    protected:
+        inline void grow(const std::size_t span_) {
+            std::vector<std::optional<T>> slots_(std::bit_ceil(span_));
+            for (std::size_t i { 0 }; i != m_slots.size(); ++i) {
+                auto& slot_ { m_slots[(m_next + i) & (m_slots.size() - 1)] };
+                if (slot_.has_value()) slots_[(m_next + i) & (slots_.size() - 1)] = std::move(slot_);
+            }
+            m_slots = std::move(slots_);
+        }
+
+    private:
+        std::vector<std::optional<T>> m_slots;
+        std::size_t                   m_next;
+        std::size_t const             m_limit;
+        std::size_t                   m_size { 0 };
+    };
+}
@@ -1,7 +1,9 @@
 #include <stdio.h>
 
 #include <queue>
+#include <memory>
 #include <thread>
+#include <vector>
 
 #include "imgui.h"
 
@@ -16,6 +18,10 @@
 
 #include "qr_cpp.hpp"
 
+#include "../../synchronize/broadcast.hpp"
+
+using frame_channel = ubn::broadcast<cv::Mat, ubn::overwrite_slowest>;
+
 static void glfw_error_callback(int error, const char *description) {
     fprintf(stderr, "Glfw Error %d: %s\n", error, description);
 }
@@ -57,6 +63,16 @@ int main(int, char**) {
     cv::Mat image, wechat_qr_result, opencv_qr_result;
 
     std::queue<std::thread> threads_pool;
+    std::unique_ptr<frame_channel> frames;
+
+    auto stop_detectors = [&]() {
+        if (frames) frames->close();
+        while (!threads_pool.empty()) {
+            threads_pool.front().join();
+            threads_pool.pop();
+        }
+        frames.reset();
+    };
 
     auto opencv_qr_app = qr_cpp::CV_App();
     auto wechat_qr_app = qr_cpp::WC_App();
@@ -80,50 +96,48 @@ int main(int, char**) {
             if (cap.isOpened()) {
                 cap.read(image);
                 if (image.empty()) cap.release();
+                else if (frames) frames->push(image.clone());
             }
 
             if (ImGui::Button("LOAD")) {
                 if (!cap.isOpened()) {
+                    stop_detectors();
                     try { cap.open(buf); } catch (const std::exception& e) {
                         printf("Error: %s\n", e.what());
                         cap.release();
                     }
 
                     if (cap.isOpened()) {
-                        if (show_wechat_qr_window) threads_pool.push(std::thread([&]() {
-                            while (cap.isOpened()) {
-                                if (image.empty()) {
-                                    std::this_thread::sleep_for(std::chrono::milliseconds(15));
-                                    continue;
-                                }
-                                wechat_qr_app.detect(image);
-                                wechat_qr_app.visualize();
-                                wechat_qr_result = wechat_qr_app.get_image();
-                                std::this_thread::yield();
-                            }
-                        }));
-                        if (show_opencv_qr_window) threads_pool.push(std::thread([&]() {
-                            while (cap.isOpened()) {
-                                if (image.empty()) {
-                                    std::this_thread::sleep_for(std::chrono::milliseconds(15));
-                                    continue;
-                                }
-                                opencv_qr_app.detect(image);
-                                opencv_qr_app.visualize();
-                                opencv_qr_result = opencv_qr_app.get_image();
-                                std::this_thread::yield();
-                            }
-                        }));
+                        frames = std::make_unique<frame_channel>(4, 2);
+                        if (show_wechat_qr_window) {
+                            if (auto subscription = frames->subscribe()) {
+                                threads_pool.push(std::thread([&, subscriber = std::move(*subscription)]() mutable {
+                                    while (auto frame = subscriber.poll()) {
+                                        wechat_qr_app.detect(*frame);
+                                        wechat_qr_app.visualize();
+                                        wechat_qr_result = wechat_qr_app.get_image();
+                                    }
+                                }));
+                            } else fprintf(stderr, "Error: no free frame subscriber for the WeChat detector\n");
+                        }
+                        if (show_opencv_qr_window) {
+                            if (auto subscription = frames->subscribe()) {
+                                threads_pool.push(std::thread([&, subscriber = std::move(*subscription)]() mutable {
+                                    while (auto frame = subscriber.poll()) {
+                                        opencv_qr_app.detect(*frame);
+                                        opencv_qr_app.visualize();
+                                        opencv_qr_result = opencv_qr_app.get_image();
+                                    }
+                                }));
+                            } else fprintf(stderr, "Error: no free frame subscriber for the OpenCV detector\n");
+                        }
                     }
                 }
             }
             ImGui::SameLine();
             if (ImGui::Button("STOP")) {
                 if (cap.isOpened()) cap.release();
-                while (!threads_pool.empty()) {
-                    threads_pool.front().detach();
-                    threads_pool.pop();
-                }
+                stop_detectors();
             }
 
             ImGui::Spacing();
@@ -206,6 +220,7 @@ int main(int, char**) {
     }
 
     cap.release();
+    stop_detectors();
 
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+
+#include <cstdint>
+#include <cstddef>
+
+#include <concepts>
+#include <optional>
+
+#include "atomic_queue_limited.hpp"
+
+namespace ubn {
+    /*
+     * @brief: Multi-lane priority queue on top of the bounded ticket queue, one ubn::atomic_limited::queue per lane
+     *         - lane 0 has the highest priority, poll() serves the highest non-empty lane first
+     *         - every starvation_limit-th poll starts its scan at a rotating lane instead, so a backlogged lower lane gets at least
+     *           one item per Lanes * starvation_limit polls while higher lanes stay busy
+     *         - consumers park on a 32-bit publish counter with std::atomic::wait when nothing is visible in the lanes, producers bump it
+     *           once their item has landed, so a consumer also parks while an item is reserved but not yet in its lane
+     *         - a lane index past the last lane is clamped to the last (lowest priority) lane
+     *         - pushes reserve their item in the counter before entering a lane, close() sets the top bit of the counter so later
+     *           reservations fail and parked consumers wake up, the lanes themselves are never closed
+     *         - a push never blocks inside a lane, it parks on a space counter that consumers only bump while a producer has announced
+     *           itself, and gives its reservation back once the queue closes
+     * @param: typename, the typename of items
+     * @param: const std::size_t, the number of priority lanes
+     * @param: typename, the ticket queue policy used for every lane (must be mpmc)
+     */
+    template <typename T, const std::size_t Lanes, typename Policy = mpmc>
+    class lane_queue {
+    public:
+        static_assert(Lanes >= 1UL, "lane_queue lanes < 1");
+        static_assert(!Policy::single_producer_single_consumer, "lane_queue requires an mpmc lane policy");
+
+        using lane = atomic_limited::queue<T, Policy>;
+
+        inline explicit lane_queue(const std::size_t capacity = UINT16_MAX, const std::size_t starvation_limit = 16) :
+            m_starvation_limit { starvation_limit ? starvation_limit : 1 } {
+
+            for (auto& lane_ : m_lanes) lane_ = std::make_unique<lane>(capacity);
+        }
+
+        inline lane_queue           (const lane_queue&) = delete;
+        inline lane_queue &operator=(const lane_queue&) = delete;
+
+        /*
+         * @brief:  Push an item to a lane, blocks while that lane is full
+         * @param:  const std::size_t, the lane index, 0 for the highest priority, clamped to the last lane
+         * @return: bool, false once the queue has been closed, also if it closes while the lane is full
+         */
+        inline bool push(const std::size_t i, std::convertible_to<T> auto&& v) noexcept {
+            if (!reserve()) return false;
+
+            auto& lane_ { lane_at(i) };
+            if (!lane_.try_push(std::forward<decltype(v)>(v)) && !wait_push(lane_, std::forward<decltype(v)>(v))) {
+                unreserve();
+                return false;
+            }
+            publish(false);
+
+            return true;
+        }
+
+        inline bool try_push(const std::size_t i, std::convertible_to<T> auto&& v) noexcept {
+            if (!reserve()) return false;
+            if (!lane_at(i).try_push(std::forward<decltype(v)>(v))) {
+                unreserve();
+                return false;
+            }
+            publish(false);
+
+            return true;
+        }
+
+        /*
+         * @brief:  Poll the highest priority item, parks while every lane is empty and the queue is open
+         * @return: std::optional<T>, the polled item or std::nullopt once the queue is closed and empty
+         */
+        inline std::optional<T> poll(void) noexcept {
+            std::optional<T> tmp_;
+            consume([&tmp_](T&& v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
+
+        inline bool poll(T& out) noexcept { return consume([&out](T&& v) { out = std::move(v); }); }
+
+        /*
+         * @brief:  Poll the highest priority item and visit it in its lane slot, see atomic_limited::queue::consume()
+         * @return: bool, false once the queue is closed and empty
+         */
+        template <std::invocable<T&&> F>
+        inline bool consume(F&& f) noexcept {
+            while (true) {
+                auto const published_ { m_published.load(std::memory_order::acquire) };
+                if (try_consume(f))                                          return true;
+                if (m_size.load(std::memory_order::acquire) == m_closed_bit) return false;
+                m_published.wait(published_, std::memory_order::relaxed);
+            }
+        }
+
+        inline std::optional<T> try_poll(void) noexcept {
+            std::optional<T> tmp_;
+            try_consume([&tmp_](T&& v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
+
+        template <std::invocable<T&&> F>
+        inline bool try_consume(F&& f) noexcept {
+            auto const tick_  { m_polls.load(std::memory_order::relaxed) + 1 };
+            auto const first_ { tick_ % m_starvation_limit ? 0 : (tick_ / m_starvation_limit) % Lanes };
+
+            for (std::size_t n { 0 }; n != Lanes; ++n) {
+                if (m_lanes[(first_ + n) % Lanes]->try_consume(f)) {
+                    freed();
+                    m_polls.fetch_add(1, std::memory_order::relaxed);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /* @brief: Poll with a deadline, waits on the publish counter with ubn::wait_until while nothing is visible in the lanes */
+        template <typename Clock, typename Duration>
+        inline std::optional<T> poll_until(const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+            while (true) {
+                auto const published_ { m_published.load(std::memory_order::acquire) };
+                if (auto tmp_ { try_poll() }; tmp_.has_value()) return tmp_;
+                if (m_size.load(std::memory_order::acquire) == m_closed_bit || !wait_until(m_published, published_, deadline)) return std::nullopt;
+            }
+        }
+
+        template <typename Rep, typename Period>
+        inline std::optional<T> poll_for(const std::chrono::duration<Rep, Period>& timeout) noexcept {
+            return poll_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        inline void close(void) noexcept {
+            m_size.fetch_or(m_closed_bit, std::memory_order::seq_cst);
+            publish(true);
+            m_space.fetch_add(1, std::memory_order::release);
+            m_space.notify_all();
+        }
+
+        inline bool closed(void) const noexcept { return m_size.load(std::memory_order::acquire) & m_closed_bit; }
+
+        /*
+         * @brief:  Move out every item currently in the lanes, highest priority lane first
+         * @param:  O, output iterator receiving the items
+         * @return: O, the output iterator past the last written item
+         */
+        template <std::output_iterator<T> O>
+        inline O drain(O out) noexcept {
+            for (auto& lane_ : m_lanes) {
+                while (auto tmp_ { lane_->try_poll() }) {
+                    freed();
+                    *out++ = std::move(*tmp_);
+                }
+            }
+
+            return out;
+        }
+
+        /* @brief: Instrumentation of one lane, enabled through Policy::stats */
+        inline stats_snapshot stats(const std::size_t i) const noexcept { return m_lanes[std::min(i, Lanes - 1)]->stats(); }
+
+        inline std::size_t size(void) const noexcept { return m_size.load(std::memory_order::acquire) & ~m_closed_bit; }
+
+    protected:
+        inline bool reserve(void) noexcept {
+            if (m_size.fetch_add(1, std::memory_order::acquire) & m_closed_bit) {
+                unreserve();
+                return false;
+            }
+
+            return true;
+        }
+
+        /* @brief: Give a reservation back whose item never made it into a lane, consumers waiting for it re-check the counter */
+        inline void unreserve(void) noexcept {
+            m_size.fetch_sub(1, std::memory_order::release);
+            publish(true);
+        }
+
+        /* @brief: Bump the publish counter after an item landed or the counter changed without one, wakes parked consumers */
+        inline void publish(const bool all_) noexcept {
+            m_published.fetch_add(1, std::memory_order::release);
+            if (all_) m_published.notify_all();
+            else      m_published.notify_one();
+        }
+
+        inline lane& lane_at(const std::size_t i) noexcept { return *m_lanes[std::min(i, Lanes - 1)]; }
+
+        /*
+         * @brief:  Retry a push on a full lane until it lands or the queue closes, parked on m_space in between
+         * @note:   The waiter count and the item counter are seq_cst on both sides, so either freed() sees the waiter and bumps m_space
+         *          or the item counter load here sees the freed slot
+         */
+        inline bool wait_push(lane& lane_, auto&& v) noexcept {
+            m_push_waiters.fetch_add(1, std::memory_order::seq_cst);
+
+            auto pushed_ { false };
+            while (true) {
+                auto const space_ { m_space.load(std::memory_order::acquire) };
+                auto const size_  { m_size.load(std::memory_order::seq_cst) };
+                if ((pushed_ = lane_.try_push(std::forward<decltype(v)>(v))) || size_ & m_closed_bit) break;
+                m_space.wait(space_, std::memory_order::relaxed);
+            }
+            m_push_waiters.fetch_sub(1, std::memory_order::relaxed);
+
+            return pushed_;
+        }
+
+        /* @brief: Give the slot of a polled item back, wakes producers parked on a full lane if there are any and consumers once closed and empty */
+        inline void freed(void) noexcept {
+            if (m_size.fetch_sub(1, std::memory_order::seq_cst) == m_closed_bit + 1) publish(true);
+            if (m_push_waiters.load(std::memory_order::seq_cst)) {
+                m_space.fetch_add(1, std::memory_order::release);
+                m_space.notify_all();
+            }
+        }
+
+    private:
+        static constexpr std::size_t m_closed_bit { std::size_t { 1 } << (std::numeric_limits<std::size_t>::digits - 1) };
+
+        std::array<std::unique_ptr<lane>, Lanes> m_lanes;
+        std::size_t const                        m_starvation_limit;
+
+        alignas(hardware_destructive_interference_size) std::atomic_size_t mutable m_size         { 0 };
+        alignas(hardware_destructive_interference_size) std::atomic_uint32_t       m_published    { 0 };
+        alignas(hardware_destructive_interference_size) std::atomic_size_t mutable m_polls        { 0 };
+        alignas(hardware_destructive_interference_size) std::atomic_size_t         m_push_waiters { 0 };
+                                                        std::atomic_uint32_t       m_space        { 0 };
+    };
+}
@@ -0,0 +1,436 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <array>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <functional>
+
+#include <cstdint>
+#include <cstddef>
+
+#include <concepts>
+#include <optional>
+
+#include "../utilities/interference_size.hpp"
+#include "../utilities/wait_strategy.hpp"
+
+#include "queue_stats.hpp"
+
+namespace ubn::atomic_linked
+{
+    /*
+     * Unbounded lock-free MPMC queue (Michael-Scott linked list with a dummy head node)
+     *  - nodes are reclaimed with hazard pointers, two per thread, shared by every queue of the same T
+     *  - reclaimed nodes go to a per-queue free list and are reused by later pushes, memory is only released on destruction
+     *  - poll() parks on the item counter with std::atomic::wait once the queue is observed empty
+     *  - push() reserves its item in the counter before linking the node, close() sets the top bit of the counter so every reservation
+     *    made after it fails and every parked poll wakes up
+     */
+    template <typename T, typename Stats = no_stats>
+    class queue
+    {
+    public:
+        inline explicit queue(void) : m_head{new node}, m_tail{m_head.load(std::memory_order::relaxed)} {}
+
+        inline ~queue(void) noexcept
+        {
+            auto *head_{m_head.load(std::memory_order::acquire)};
+            while (auto *next_{head_->m_next_.load(std::memory_order::acquire)})
+            {
+                next_->destruct();
+                delete std::exchange(head_, next_);
+            }
+            delete head_;
+            release_(m_free.exchange(nullptr, std::memory_order::acquire));
+            release_(m_retired.exchange(nullptr, std::memory_order::acquire));
+        }
+
+        inline queue(const queue &) = delete;
+        inline queue &operator=(const queue &) = delete;
+
+        /*
+         * @brief:  Push an item, fails once the queue has been closed
+         * @return: bool, whether the item has been pushed
+         */
+        inline bool push(const T &v) noexcept { return emplace(v); }
+        inline bool push(std::convertible_to<T> auto &&v) noexcept { return emplace(std::forward<decltype(v)>(v)); }
+
+        /*
+         * @brief:  Poll an item, parks while the queue is empty and open
+         * @return: std::optional<T>, the polled item or std::nullopt once the queue is closed and empty
+         */
+        inline std::optional<T> poll(void) noexcept
+        {
+            std::optional<T> tmp_;
+            consume([&tmp_](T &&v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
+
+        /*
+         * @brief:  Poll an item into an existing object, move-assigned straight from the node
+         * @return: bool, false once the queue is closed and empty
+         */
+        inline bool poll(T &out) noexcept
+        {
+            return consume([&out](T &&v) { out = std::move(v); });
+        }
+
+        /*
+         * @brief:  Poll an item and visit it in its node, the node is retired once the visitor returns
+         * @param:  F&&, invocable with T&&, may move from the item or only read it
+         * @return: bool, false once the queue is closed and empty
+         */
+        template <std::invocable<T &&> F>
+        inline bool consume(F &&f) noexcept
+        {
+            while (true)
+            {
+                if (try_consume(f))
+                    return true;
+
+                auto const size_{m_size.load(std::memory_order::acquire)};
+                if (size_ & ~m_closed_bit)
+                    std::this_thread::yield();
+                else if (size_ & m_closed_bit)
+                    return false;
+                else
+                {
+                    auto const since_{blocked_since<Stats>()};
+                    m_stats.waited();
+                    m_size.wait(size_, std::memory_order::relaxed);
+                    m_stats.poll_blocked(blocked_for<Stats>(since_));
+                }
+            }
+        }
+
+        inline std::optional<T> try_poll(void) noexcept
+        {
+            std::optional<T> tmp_;
+            try_consume([&tmp_](T &&v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
+
+        /*
+         * @brief:  Visit the front item in its node without waiting, see consume()
+         * @return: bool, whether an item has been visited
+         */
+        template <std::invocable<T &&> F>
+        inline bool try_consume(F &&f) noexcept
+        {
+            auto &hazards_{local_hazards_()};
+
+            while (true)
+            {
+                auto *head_{protect_(hazards_[0], m_head)};
+                auto *tail_{m_tail.load(std::memory_order::acquire)};
+                auto *next_{head_->m_next_.load(std::memory_order::acquire)};
+                hazards_[1].store(next_, std::memory_order::seq_cst);
+                if (m_head.load(std::memory_order::seq_cst) != head_)
+                    continue;
+
+                if (!next_)
+                    break;
+
+                if (head_ == tail_)
+                {
+                    m_tail.compare_exchange_weak(tail_, next_, std::memory_order::release, std::memory_order::relaxed);
+                    continue;
+                }
+
+                if (m_head.compare_exchange_weak(head_, next_, std::memory_order::acq_rel, std::memory_order::relaxed))
+                {
+                    std::invoke(std::forward<F>(f), next_->move());
+                    next_->destruct();
+                    m_size.fetch_sub(1, std::memory_order::release);
+                    m_stats.polled();
+
+                    hazards_[0].store(nullptr, std::memory_order::release);
+                    hazards_[1].store(nullptr, std::memory_order::release);
+                    retire_(head_);
+
+                    return true;
+                }
+            }
+
+            hazards_[0].store(nullptr, std::memory_order::release);
+            hazards_[1].store(nullptr, std::memory_order::release);
+
+            return false;
+        }
+
+        /*
+         * @brief:  Poll with a deadline, waits on the item counter with ubn::wait_until while the queue is empty
+         * @return: std::optional<T>, the polled item or std::nullopt once the deadline has been reached or the queue is closed and empty
+         */
+        template <typename Clock, typename Duration>
+        inline std::optional<T> poll_until(const std::chrono::time_point<Clock, Duration> &deadline) noexcept
+        {
+            while (true)
+            {
+                if (auto tmp_{try_poll()}; tmp_.has_value())
+                    return tmp_;
+
+                auto const size_{m_size.load(std::memory_order::acquire)};
+                if (size_ & ~m_closed_bit)
+                {
+                    if (Clock::now() >= deadline)
+                        return std::nullopt;
+                    std::this_thread::yield();
+                }
+                else if (size_ & m_closed_bit || !wait_until(m_size, size_, deadline))
+                    return std::nullopt;
+            }
+        }
+
+        template <typename Rep, typename Period>
+        inline std::optional<T> poll_for(const std::chrono::duration<Rep, Period> &timeout) noexcept
+        {
+            return poll_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        /*
+         * @brief: Close the queue, pushes fail from now on and every parked poll wakes up, items already queued can still be polled
+         */
+        inline void close(void) noexcept
+        {
+            m_size.fetch_or(m_closed_bit, std::memory_order::acq_rel);
+            m_size.notify_all();
+        }
+
+        inline bool closed(void) const noexcept { return m_size.load(std::memory_order::acquire) & m_closed_bit; }
+
+        /*
+         * @brief:  Move out all items currently linked
+         * @param:  O, output iterator receiving the items in FIFO order
+         * @return: O, the output iterator past the last written item
+         */
+        template <std::output_iterator<T> O>
+        inline O drain(O out) noexcept
+        {
+            while (auto tmp_{try_poll()})
+                *out++ = std::move(*tmp_);
+
+            return out;
+        }
+
+        inline stats_snapshot stats(void) const noexcept { return m_stats.snapshot(); }
+
+        inline std::size_t size(void) const noexcept
+        {
+            return static_cast<std::size_t>(m_size.load(std::memory_order::acquire) & ~m_closed_bit);
+        }
+
+    protected:
+        struct node
+        {
+        public:
+            template <typename... Args>
+            inline void construct(Args &&...args) noexcept { new (&m_storage_) T(std::forward<Args>(args)...); }
+            inline void destruct(void) noexcept { reinterpret_cast<T *>(&m_storage_)->~T(); }
+            inline T &&move(void) noexcept { return reinterpret_cast<T &&>(m_storage_); }
+
+            std::atomic<node *> m_next_{nullptr};
+            std::atomic<node *> m_link_{nullptr};
+
+        private:
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage_;
+        };
+
+        using hazards = std::array<std::atomic<node *>, 2>;
+
+        struct hazard_record
+        {
+            hazards m_hazards_{};
+            std::atomic_flag m_active_{ATOMIC_FLAG_INIT};
+            hazard_record *m_next_{nullptr};
+        };
+
+        template <typename... Args>
+        inline bool emplace(Args &&...args) noexcept
+        {
+            auto const size_{m_size.fetch_add(1, std::memory_order::acquire)};
+            if (size_ & m_closed_bit)
+            {
+                m_size.fetch_sub(1, std::memory_order::release);
+                return false;
+            }
+
+            auto *node_{acquire_()};
+            node_->construct(std::forward<Args>(args)...);
+            node_->m_next_.store(nullptr, std::memory_order::relaxed);
+
+            auto &hazards_{local_hazards_()};
+            while (true)
+            {
+                auto *tail_{protect_(hazards_[0], m_tail)};
+                auto *next_{tail_->m_next_.load(std::memory_order::acquire)};
+                if (m_tail.load(std::memory_order::acquire) != tail_)
+                    continue;
+
+                if (next_)
+                {
+                    m_tail.compare_exchange_weak(tail_, next_, std::memory_order::release, std::memory_order::relaxed);
+                    continue;
+                }
+
+                if (tail_->m_next_.compare_exchange_weak(next_, node_, std::memory_order::release, std::memory_order::relaxed))
+                {
+                    m_tail.compare_exchange_strong(tail_, node_, std::memory_order::release, std::memory_order::relaxed);
+                    break;
+                }
+            }
+            hazards_[0].store(nullptr, std::memory_order::release);
+
+            m_size.notify_one();
+            m_stats.pushed(static_cast<std::size_t>(size_ + 1));
+
+            return true;
+        }
+
+        /* @brief: Load and publish a hazard pointer until the published value is still current */
+        inline static node *protect_(std::atomic<node *> &hazard_, const std::atomic<node *> &source_) noexcept
+        {
+            auto *ptr_{source_.load(std::memory_order::acquire)};
+            while (true)
+            {
+                hazard_.store(ptr_, std::memory_order::seq_cst);
+                auto *now_{source_.load(std::memory_order::seq_cst)};
+                if (now_ == ptr_)
+                    return ptr_;
+                ptr_ = now_;
+            }
+        }
+
+        /* @brief: Take a node from the free list, protected by a hazard pointer against ABA, allocates only when the list is empty */
+        inline node *acquire_(void) noexcept
+        {
+            auto &hazards_{local_hazards_()};
+            while (true)
+            {
+                auto *free_{protect_(hazards_[0], m_free)};
+                if (!free_)
+                    break;
+                auto *next_{free_->m_link_.load(std::memory_order::relaxed)};
+                if (m_free.compare_exchange_weak(free_, next_, std::memory_order::acquire, std::memory_order::relaxed))
+                {
+                    hazards_[0].store(nullptr, std::memory_order::release);
+                    return free_;
+                }
+            }
+            hazards_[0].store(nullptr, std::memory_order::release);
+
+            return new node;
+        }
+
+        inline void retire_(node *node_) noexcept
+        {
+            push_(m_retired, node_);
+            if (m_retired_size.fetch_add(1, std::memory_order::relaxed) + 1 < m_scan_threshold)
+                return;
+
+            m_retired_size.store(0, std::memory_order::relaxed);
+            scan_(m_retired.exchange(nullptr, std::memory_order::acquire));
+        }
+
+        /* @brief: Move every retired node no thread holds a hazard pointer to into the free list, keep the rest retired */
+        inline void scan_(node *retired_) noexcept
+        {
+            while (retired_)
+            {
+                auto *next_{retired_->m_link_.load(std::memory_order::relaxed)};
+                push_(is_hazardous_(retired_) ? m_retired : m_free, retired_);
+                retired_ = next_;
+            }
+        }
+
+        /* @brief: Push onto a free or retired list through m_link_, m_next_ of a retired node must stay intact for late readers */
+        inline static void push_(std::atomic<node *> &list_, node *node_) noexcept
+        {
+            auto *top_{list_.load(std::memory_order::relaxed)};
+            do
+                node_->m_link_.store(top_, std::memory_order::relaxed);
+            while (!list_.compare_exchange_weak(top_, node_, std::memory_order::release, std::memory_order::relaxed));
+        }
+
+        inline static void release_(node *node_) noexcept
+        {
+            while (node_)
+                delete std::exchange(node_, node_->m_link_.load(std::memory_order::relaxed));
+        }
+
+        inline static bool is_hazardous_(const node *node_) noexcept
+        {
+            for (auto *record_{s_records.load(std::memory_order::acquire)}; record_; record_ = record_->m_next_)
+                for (auto const &hazard_ : record_->m_hazards_)
+                    if (hazard_.load(std::memory_order::seq_cst) == node_)
+                        return true;
+
+            return false;
+        }
+
+        /* @brief: Hazard pointers of the calling thread, records are leased per thread and returned on thread exit, never freed */
+        inline static hazards &local_hazards_(void) noexcept
+        {
+            struct lease
+            {
+                inline lease(void) noexcept
+                {
+                    for (auto *record_{s_records.load(std::memory_order::acquire)}; record_; record_ = record_->m_next_)
+                        if (!record_->m_active_.test_and_set(std::memory_order::acquire))
+                        {
+                            p_record = record_;
+                            return;
+                        }
+
+                    p_record = new hazard_record;
+                    p_record->m_active_.test_and_set(std::memory_order::relaxed);
+                    p_record->m_next_ = s_records.load(std::memory_order::relaxed);
+                    while (!s_records.compare_exchange_weak(p_record->m_next_, p_record, std::memory_order::release, std::memory_order::relaxed))
+                        ;
+                }
+
+                inline ~lease(void) noexcept
+                {
+                    for (auto &hazard_ : p_record->m_hazards_)
+                        hazard_.store(nullptr, std::memory_order::release);
+                    p_record->m_active_.clear(std::memory_order::release);
+                }
+
+                hazard_record *p_record;
+            };
+            static thread_local lease s_lease;
+
+            return s_lease.p_record->m_hazards_;
+        }
+
+    private:
+        static constexpr std::size_t m_scan_threshold{64};
+        static constexpr std::ptrdiff_t m_closed_bit{std::ptrdiff_t{1} << (sizeof(std::ptrdiff_t) * 8 - 2)};
+
+        inline static std::atomic<hazard_record *> s_records{nullptr};
+
+        alignas(hardware_destructive_interference_size) std::atomic<node *> m_head;
+        alignas(hardware_destructive_interference_size) std::atomic<node *> m_tail;
+        alignas(hardware_destructive_interference_size) mutable std::atomic<std::ptrdiff_t> m_size{0};
+
+        alignas(hardware_destructive_interference_size) std::atomic<node *> m_free{nullptr};
+        alignas(hardware_destructive_interference_size) std::atomic<node *> m_retired{nullptr};
+        std::atomic<std::size_t> m_retired_size{0};
+
+        [[no_unique_address]] Stats m_stats;
+    };
+}
+
+#ifndef UBN_QUEUE_NAMESPACED
+namespace ubn
+{
+    using atomic_linked::queue;
+}
+#endif
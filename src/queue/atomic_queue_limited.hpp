@@ -1,10 +1,18 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <thread>
 
 #include <memory>
 #include <limits>
 #include <ranges>
+#include <utility>
+#include <functional>
+#include <iterator>
+#include <algorithm>
+
+#include <bit>
 
 #include <cstdint>
 #include <cstddef>
@@ -12,22 +20,71 @@
 #include <concepts>
 #include <optional>
 
+#include "../utilities/interference_size.hpp"
+#include "../utilities/wait_strategy.hpp"
+
+#include "queue_stats.hpp"
+
 namespace ubn {
-    static constexpr std::size_t hardware_constructive_interference_size { 2 * sizeof(std::max_align_t) };
+    /*
+     * @brief: Slot layouts of the ticket queue, the alignment of each slot (ticket and storage)
+     *         - packed:      no padding, adjacent slots share cache lines
+     *         - padded:      one slot per destructive interference size (cache line)
+     *         - padded_pair: two cache lines per slot, keeps the adjacent-line prefetcher from pulling in a neighbour slot
+     */
+    struct packed      { static constexpr std::size_t alignment { alignof(std::atomic_size_t) };                  };
+    struct padded      { static constexpr std::size_t alignment { hardware_destructive_interference_size };       };
+    struct padded_pair { static constexpr std::size_t alignment { 2 * hardware_destructive_interference_size };   };
+
+    /*
+     * @brief: Queue policies, selects the implementation of ubn::queue at compile time, derive and override members to customize
+     *         - mpmc: ticket based slots, any number of producers and consumers
+     *         - spsc: exactly one producer thread and one consumer thread, no RMW on the hot path
+     *         - power_of_two_capacity: rounds the capacity up to a power of two, slot index and ticket become mask and shift (mpmc only)
+     *         - wait_strategy: how a blocked push or poll waits, see ubn::spin_wait, ubn::spin_then_park and ubn::park_wait
+     *         - stats: instrumentation, ubn::no_stats compiles it out, ubn::queue_stats counts, see queue_stats.hpp
+     */
+    struct mpmc {
+        static constexpr bool single_producer_single_consumer { false };
+        static constexpr bool power_of_two_capacity           { false };
+
+        using layout        = padded;
+        using wait_strategy = park_wait;
+        using stats         = no_stats;
+    };
 
-    template <typename T>
+    struct spsc {
+        static constexpr bool single_producer_single_consumer { true };
+        static constexpr bool power_of_two_capacity           { false };
+
+        using layout        = packed;
+        using wait_strategy = park_wait;
+        using stats         = no_stats;
+    };
+}
+
+namespace ubn::atomic_limited {
+    /*
+     * @brief: Bounded ticket queue, producers and consumers take tickets with fetch_add and wait on their slot
+     *         - close() sets the top bit of the producer ticket, pushes that draw a closed ticket fail, pushes drawn before it still land
+     *           unless they are waiting for a full slot, those give their ticket up and fail too
+     *         - consumers whose ticket is past the closing point wake up and return std::nullopt once the queue is closed, a ticket given up
+     *           by a producer moves the closing point down to it, so items pushed behind it are only dropped with the queue
+     */
+    template <typename T, typename Policy = mpmc>
     class queue {
     public:
         inline explicit queue(const std::size_t capacity = UINT16_MAX) :
-            m_capacity  { capacity },
+            m_capacity  { Policy::power_of_two_capacity ? std::bit_ceil(capacity) : capacity },
+            m_mask      { m_capacity - 1 },
+            m_shift     { static_cast<std::size_t>(std::countr_zero(m_capacity)) },
+            m_closed_at { SIZE_MAX },
             m_allocator { std::allocator<container<T>>() },
             m_front     { ATOMIC_VAR_INIT(0) },
             m_back      { ATOMIC_VAR_INIT(0) } {
-                
-            m_containers = m_allocator.allocate(m_capacity + 1);
 
-            if  (reinterpret_cast<std::size_t>(m_containers) % alignof(container<T>)) m_allocator.deallocate(m_containers, m_capacity + 1);
-            for (auto i : std::views::iota(0u, m_capacity))                           new (&m_containers[i]) container<T>();
+            m_containers = m_allocator.allocate(m_capacity + 1);
+            for (auto i : std::views::iota(0u, m_capacity)) new (&m_containers[i]) container<T>();
         }
 
         inline ~queue(void) noexcept {
@@ -38,69 +95,614 @@ namespace ubn {
         inline queue           (const queue&) = delete;
         inline queue &operator=(const queue&) = delete;
 
-        inline void push(const T& v)                      noexcept { emplace(v); }
-        inline void push(std::convertible_to<T> auto&& v) noexcept { emplace(std::forward<decltype(v)>(v)); }
+        /*
+         * @brief:  Push an item, blocks while the slot of the ticket is occupied (queue is full)
+         * @return: bool, whether the item has been pushed, false once the queue has been closed, also if it closes while waiting
+         */
+        inline bool push(const T& v)                      noexcept { return emplace(v); }
+        inline bool push(std::convertible_to<T> auto&& v) noexcept { return emplace(std::forward<decltype(v)>(v)); }
+
+        /*
+         * @brief:  Poll an item, blocks while the slot of the ticket is empty
+         * @return: std::optional<T>, the polled item or std::nullopt once the queue has been closed and no item is left for the ticket
+         */
+        inline std::optional<T> poll(void) noexcept { return take(m_back.fetch_add(1, std::memory_order::acquire)); }
+
+        /*
+         * @brief:  Poll an item into an existing object, move-assigned straight from the slot without an intermediate std::optional
+         * @param:  T&, the object receiving the item, left untouched if nothing has been polled
+         * @return: bool, false once the queue has been closed and no item is left for the ticket
+         */
+        inline bool poll(T& out) noexcept { return consume([&out](T&& v) { out = std::move(v); }); }
+
+        /*
+         * @brief:  Poll an item and visit it in its slot, the slot is released once the visitor returns, so keep the visitor short
+         * @param:  F&&, invocable with T&&, may move from the item or only read it
+         * @return: bool, false once the queue has been closed and no item is left for the ticket
+         */
+        template <std::invocable<T&&> F>
+        inline bool consume(F&& f) noexcept { return take(m_back.fetch_add(1, std::memory_order::acquire), std::forward<F>(f)); }
+
+        /*
+         * @brief: Close the queue, every slot is touched once so that parked consumers re-check their ticket against the closing point
+         *         and parked producers give up
+         */
+        inline void close(void) noexcept {
+            auto const head_ { m_front.fetch_or(m_closed_bit, std::memory_order::seq_cst) };
+            if (head_ & m_closed_bit) return;
+
+            lower_closed_at(head_);
+            touch([](std::atomic_size_t& ticket_) { ticket_.fetch_or(m_closed_bit, std::memory_order::seq_cst); });
+        }
+
+        inline bool closed(void) const noexcept { return m_front.load(std::memory_order::acquire) & m_closed_bit; }
+
+        /*
+         * @brief:  Move out every item that is ready now, without waiting for pushes still in flight
+         * @param:  O, output iterator receiving the items in FIFO order
+         * @return: O, the output iterator past the last written item
+         */
+        template <std::output_iterator<T> O>
+        inline O drain(O out) noexcept {
+            while (auto tmp_ { try_poll() }) *out++ = std::move(*tmp_);
+
+            return out;
+        }
+
+        inline stats_snapshot stats(void) const noexcept { return m_stats.snapshot(); }
 
-        inline T poll(void) noexcept {
+        /*
+         * @brief:  Push without waiting, fails if the slot of the next ticket is still occupied (queue is full)
+         * @return: bool, whether the item has been pushed
+         */
+        inline bool try_push(const T& v)                      noexcept { return try_emplace(v); }
+        inline bool try_push(std::convertible_to<T> auto&& v) noexcept { return try_emplace(std::forward<decltype(v)>(v)); }
+
+        /*
+         * @brief:  Poll without waiting, returns std::nullopt if the slot of the next ticket is not yet filled (queue is empty)
+         * @return: std::optional<T>, the polled item if any
+         */
+        inline std::optional<T> try_poll(void) noexcept {
             std::optional<T> tmp_;
+            try_consume([&tmp_](T&& v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
 
-            auto const tail_      { m_back.fetch_add(1, std::memory_order::acquire) };
-            auto&      container_ { m_containers[m_index(tail_)] };
-            auto const ticket_    { m_ticket(tail_) * 2 + 1 };
+        /*
+         * @brief:  Visit the item of the next ticket in its slot without waiting, see consume()
+         * @return: bool, whether an item has been visited
+         */
+        template <std::invocable<T&&> F>
+        inline bool try_consume(F&& f) noexcept {
+            auto tail_ { m_back.load(std::memory_order::acquire) };
             while (true) {
-                auto const now_ { container_.m_ticket_.load(std::memory_order::acquire) };
-                if (now_ == ticket_) break;
-                container_.m_ticket_.wait(now_, std::memory_order::relaxed);
+                auto const now_ { m_containers[m_index(tail_)].m_ticket_.load(std::memory_order::acquire) & ~m_flag_bits };
+                if (now_ == m_ticket(tail_) * 2 + 1) {
+                    if (m_back.compare_exchange_weak(tail_, tail_ + 1, std::memory_order::acquire, std::memory_order::relaxed)) return take(tail_, std::forward<F>(f));
+                } else {
+                    auto const prev_ { std::exchange(tail_, m_back.load(std::memory_order::acquire)) };
+                    if (tail_ == prev_) return false;
+                }
             }
-            tmp_ = container_.move();
-            container_.destruct();
-            container_.m_ticket_.store(m_ticket(tail_) * 2 + 2, std::memory_order::release);
-            container_.m_ticket_.notify_all();
+        }
 
-            return std::move(*tmp_);
+        /*
+         * @brief:  Poll with a deadline, waits on the slot of the next ticket with ubn::wait_until between attempts
+         * @param:  const std::chrono::time_point<Clock, Duration>&, the absolute deadline
+         * @return: std::optional<T>, the polled item or std::nullopt if the deadline has been reached or the queue is closed and empty
+         * @note:   close() sets a bit in every slot, so a closing queue changes the value that is waited on as well
+         */
+        template <typename Clock, typename Duration>
+        inline std::optional<T> poll_until(const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+            while (true) {
+                if (auto tmp_ { try_poll() }; tmp_.has_value()) return tmp_;
+                if (exhausted()) return std::nullopt;
+
+                auto const  tail_   { m_back.load(std::memory_order::acquire) };
+                auto const& ticket_ { m_containers[m_index(tail_)].m_ticket_ };
+                auto const  now_    { ticket_.load(std::memory_order::acquire) };
+                if ((now_ & ~m_flag_bits) > m_ticket(tail_) * 2) continue;
+                if (!wait_until(ticket_, now_, deadline))         return std::nullopt;
+            }
+        }
+
+        template <typename Rep, typename Period>
+        inline std::optional<T> poll_for(const std::chrono::duration<Rep, Period>& timeout) noexcept {
+            return poll_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        /*
+         * @brief:  Push all items of a sized range, reserving contiguous tickets with a single fetch_add, waits on each slot like push
+         * @param:  R&&, a sized range whose references are convertible to T, wrap with std::views::transform or move iterators to move from it
+         */
+        template <std::ranges::sized_range R> requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+        inline bool push_bulk(R&& r) noexcept {
+            auto const n_ { static_cast<std::size_t>(std::ranges::size(r)) };
+            if (!n_) return true;
+
+            auto head_ { m_front.fetch_add(n_, std::memory_order::acquire) };
+            if (head_ & m_closed_bit) return false;
+
+            auto pushed_ { true };
+            for (auto&& v : r) pushed_ &= emplace_at(head_++, std::forward<decltype(v)>(v));
+
+            return pushed_;
+        }
+
+        /*
+         * @brief:  Poll n items into an output iterator, reserving contiguous tickets with a single fetch_add, waits until all n items have been polled
+         * @param:  O, output iterator receiving the polled items in FIFO order
+         * @param:  const std::size_t, the number of items to poll
+         * @return: O, the output iterator past the last written item, stops early once the queue has been closed and runs out of items
+         */
+        template <std::output_iterator<T> O>
+        inline O poll_bulk(O out, const std::size_t n) noexcept {
+            if (!n) return out;
+
+            auto tail_ { m_back.fetch_add(n, std::memory_order::acquire) };
+            for (auto i : std::views::iota(0ul, n)) {
+                if (!take(tail_ + i, [&out](T&& v) { *out++ = std::move(v); })) break;
+            }
+
+            return out;
         }
 
     protected:
         template <typename... Args>
-        inline void emplace(Args&&... args) noexcept {
-            auto const head_      { m_front.fetch_add(1, std::memory_order::acquire) };
-            auto&      container_ { m_containers[m_index(head_)] };
-            auto const ticket_    { m_ticket(head_) * 2 };
+        inline bool emplace(Args&&... args) noexcept {
+            auto const head_ { m_front.fetch_add(1, std::memory_order::acquire) };
+            if (head_ & m_closed_bit) return false;
+
+            return emplace_at(head_, std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        inline bool try_emplace(Args&&... args) noexcept {
+            auto head_ { m_front.load(std::memory_order::acquire) };
             while (true) {
-                auto const now_ { container_.m_ticket_.load(std::memory_order::acquire) };
-                if (now_ == ticket_) break;
-                container_.m_ticket_.wait(now_, std::memory_order::relaxed);
+                if (head_ & m_closed_bit) return false;
+
+                auto const now_ { m_containers[m_index(head_)].m_ticket_.load(std::memory_order::acquire) & ~m_flag_bits };
+                if (now_ == m_ticket(head_) * 2) {
+                    if (m_front.compare_exchange_weak(head_, head_ + 1, std::memory_order::acquire, std::memory_order::relaxed))
+                        return emplace_at(head_, std::forward<Args>(args)...);
+                } else {
+                    auto const prev_ { std::exchange(head_, m_front.load(std::memory_order::acquire)) };
+                    if (head_ == prev_) return false;
+                }
             }
+        }
+
+        template <typename... Args>
+        inline bool emplace_at(const std::size_t head_, Args&&... args) noexcept {
+            auto& container_ { m_containers[m_index(head_)] };
+            if (!wait(container_, m_ticket(head_) * 2, head_, false)) return false;
             container_.construct(std::forward<Args>(args)...);
             container_.m_ticket_.store(m_ticket(head_) * 2 + 1, std::memory_order::release);
-            container_.m_ticket_.notify_all();
+            Policy::wait_strategy::notify(container_.m_ticket_);
+
+            if constexpr (Policy::stats::enabled) {
+                auto const tail_ { m_back.load(std::memory_order::relaxed) };
+                m_stats.pushed(head_ + 1 > tail_ ? head_ + 1 - tail_ : 0);
+            }
+
+            return true;
+        }
+
+        inline std::optional<T> take(const std::size_t tail_) noexcept {
+            std::optional<T> tmp_;
+            take(tail_, [&tmp_](T&& v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
+
+        /* @brief: Wait for the item of the ticket, hand it to the visitor in place, then destroy it and release the slot */
+        template <typename F>
+        inline bool take(const std::size_t tail_, F&& f) noexcept {
+            auto& container_ { m_containers[m_index(tail_)] };
+            if (!wait(container_, m_ticket(tail_) * 2 + 1, tail_, true)) return false;
+            std::invoke(std::forward<F>(f), container_.move());
+            container_.destruct();
+            container_.m_ticket_.store(m_ticket(tail_) * 2 + 2, std::memory_order::release);
+            Policy::wait_strategy::notify(container_.m_ticket_);
+            m_stats.polled();
+
+            return true;
         }
 
         template <typename V>
-        struct container {
+        struct alignas(Policy::layout::alignment) alignas(V) container {
         public:
-            inline ~container    (void)           noexcept { if (m_ticket_.load(std::memory_order::acquire)) destruct(); }
+            inline ~container    (void)           noexcept { if (m_ticket_.load(std::memory_order::acquire) & 1) destruct(); }
 
             template <typename... Args>
             inline void construct(Args&&... args) noexcept { new (&m_storage_) V(std::forward<Args>(args)...); }
             inline void destruct (void)           noexcept { reinterpret_cast<V*>(&m_storage_)->~V(); }
             inline V&&  move     (void)           noexcept { return reinterpret_cast<V&&>(m_storage_); }
 
-            alignas(hardware_constructive_interference_size) std::atomic_size_t mutable m_ticket_ { 0 };
+            std::atomic_size_t mutable m_ticket_ { 0 };
 
         private:
             typename std::aligned_storage<sizeof(V), alignof(V)>::type m_storage_;
         };
 
+        /*
+         * @brief:  Wait until the slot holds the ticket, a consumer gives up once the queue is closed before its position, a producer
+         *          gives up once the queue is closed at all and moves the closing point down to its ticket, which is never filled
+         * @return: bool, false if the caller gave up
+         * @note:   The slot, the closing point and the producer ticket are loaded seq_cst, either the close is seen or the bits close()
+         *          and a giving up producer set in every slot change the value that is waited on
+         */
+        inline bool wait(const container<T>& container_, const std::size_t ticket_, const std::size_t position_, const bool polling_) noexcept {
+            auto now_ { container_.m_ticket_.load(std::memory_order::acquire) };
+            if ((now_ & ~m_flag_bits) == ticket_) return true;
+
+            auto const since_ { blocked_since<typename Policy::stats>() };
+            auto       ready_ { true };
+            while (((now_ = container_.m_ticket_.load(std::memory_order::seq_cst)) & ~m_flag_bits) != ticket_) {
+                if (polling_ && position_ >= m_closed_at.load(std::memory_order::seq_cst)) {
+                    ready_ = false;
+                    break;
+                }
+                if (!polling_ && m_front.load(std::memory_order::seq_cst) & m_closed_bit) {
+                    lower_closed_at(position_);
+                    touch([](std::atomic_size_t& ticket_) { ticket_.fetch_xor(m_wake_bit, std::memory_order::seq_cst); });
+                    ready_ = false;
+                    break;
+                }
+                m_stats.waited();
+                Policy::wait_strategy::wait(container_.m_ticket_, now_);
+            }
+
+            if (polling_) m_stats.poll_blocked(blocked_for<typename Policy::stats>(since_));
+            else          m_stats.push_blocked(blocked_for<typename Policy::stats>(since_));
+
+            return ready_;
+        }
+
+        /* @brief: Move the closing point down to the position, it only ever moves down */
+        inline void lower_closed_at(const std::size_t position_) noexcept {
+            for (auto at_ { m_closed_at.load(std::memory_order::seq_cst) }; position_ < at_ && !m_closed_at.compare_exchange_weak(at_, position_, std::memory_order::seq_cst);) {}
+        }
+
+        /* @brief: Change a flag bit of every slot and wake its waiters, so they re-check the closing point */
+        template <typename F>
+        inline void touch(F&& f_) noexcept {
+            for (auto i : std::views::iota(0u, m_capacity)) {
+                std::invoke(f_, m_containers[i].m_ticket_);
+                m_containers[i].m_ticket_.notify_all();
+            }
+        }
+
+        /* @brief: Whether the queue has been closed and every ticket before the closing point has been taken by a consumer */
+        inline bool exhausted(void) const noexcept {
+            return m_back.load(std::memory_order::acquire) >= m_closed_at.load(std::memory_order::seq_cst);
+        }
+
     private:
-        constexpr std::size_t m_index (const std::size_t i) const noexcept { return reinterpret_cast<std::size_t>(i % m_capacity); }
-        constexpr std::size_t m_ticket(const std::size_t i) const noexcept { return reinterpret_cast<std::size_t>(i / m_capacity); }
+        constexpr std::size_t m_index(const std::size_t i) const noexcept {
+            if constexpr (Policy::power_of_two_capacity) return i & m_mask;
+            else                                         return i % m_capacity;
+        }
+
+        constexpr std::size_t m_ticket(const std::size_t i) const noexcept {
+            if constexpr (Policy::power_of_two_capacity) return i >> m_shift;
+            else                                         return i / m_capacity;
+        }
 
         container<T>*                m_containers;
         std::size_t const            m_capacity;
+        std::size_t const            m_mask;
+        std::size_t const            m_shift;
+        std::atomic_size_t           m_closed_at;
         std::allocator<container<T>> m_allocator [[no_unique_address]];
-        
-        alignas(hardware_constructive_interference_size) std::atomic_size_t mutable m_front;
-        alignas(hardware_constructive_interference_size) std::atomic_size_t mutable m_back;
+        typename Policy::stats       m_stats     [[no_unique_address]];
+
+        static constexpr std::size_t m_closed_bit { std::size_t { 1 } << (std::numeric_limits<std::size_t>::digits - 1) };
+        static constexpr std::size_t m_wake_bit   { m_closed_bit >> 1 };
+        static constexpr std::size_t m_flag_bits  { m_closed_bit | m_wake_bit };
+
+        alignas(hardware_destructive_interference_size) std::atomic_size_t mutable m_front;
+        alignas(hardware_destructive_interference_size) std::atomic_size_t mutable m_back;
     };
+
+    /*
+     * @brief: Single producer single consumer ring, head and tail are each written by one side only and cached by the other
+     *         - close() raises a flag and sets the top bit of the head and tail indices so that a parked consumer or producer sees a new
+     *           value and re-checks it, a producer parked on a full ring then fails its push
+     *         - the indices are 32-bit futex words, so publishing one is a plain store plus a notify that only makes a syscall while a thread
+     *           is parked, wider atomics go through the waiter pool of the standard library and pay a shared fetch_add on every notify,
+     *           the capacity is clamped to 2^31 - 2 for that
+     */
+    template <typename T, typename Policy> requires (Policy::single_producer_single_consumer)
+    class queue<T, Policy> {
+    public:
+        inline explicit queue(const std::size_t capacity = UINT16_MAX) :
+            m_capacity    { std::min<std::size_t>(capacity, m_closed_bit - 1) + 1 },
+            m_allocator   { std::allocator<container>() },
+            m_head        { ATOMIC_VAR_INIT(0) },
+            m_cached_tail { 0 },
+            m_tail        { ATOMIC_VAR_INIT(0) },
+            m_cached_head { 0 } {
+
+            m_containers = m_allocator.allocate(m_capacity);
+        }
+
+        inline ~queue(void) noexcept {
+            for (auto i { m_tail.load(std::memory_order::acquire) & ~m_closed_bit }; i != (m_head.load(std::memory_order::acquire) & ~m_closed_bit); i = m_next(i))
+                reinterpret_cast<T*>(&m_containers[i])->~T();
+            m_allocator.deallocate(m_containers, m_capacity);
+        }
+
+        inline queue           (const queue&) = delete;
+        inline queue &operator=(const queue&) = delete;
+
+        inline bool push(const T& v)                      noexcept { return emplace(v); }
+        inline bool push(std::convertible_to<T> auto&& v) noexcept { return emplace(std::forward<decltype(v)>(v)); }
+
+        inline std::optional<T> poll(void) noexcept {
+            auto const tail_ { m_tail.load(std::memory_order::relaxed) & ~m_closed_bit };
+            if (!wait_head(tail_)) return std::nullopt;
+
+            return take(tail_);
+        }
+
+        inline bool poll(T& out) noexcept { return consume([&out](T&& v) { out = std::move(v); }); }
+
+        template <std::invocable<T&&> F>
+        inline bool consume(F&& f) noexcept {
+            auto const tail_ { m_tail.load(std::memory_order::relaxed) & ~m_closed_bit };
+            if (!wait_head(tail_)) return false;
+
+            return take(tail_, std::forward<F>(f));
+        }
+
+        /*
+         * @brief: Close the queue, may be called from any thread, a push racing with it may still land and is left for drain()
+         */
+        inline void close(void) noexcept {
+            m_closed.store(true, std::memory_order::seq_cst);
+            m_head.fetch_or(m_closed_bit, std::memory_order::seq_cst);
+            m_head.notify_all();
+            m_tail.fetch_or(m_closed_bit, std::memory_order::seq_cst);
+            m_tail.notify_all();
+        }
+
+        inline bool closed(void) const noexcept { return m_closed.load(std::memory_order::acquire); }
+
+        /* @brief: Move out every item currently published, consumer side only */
+        template <std::output_iterator<T> O>
+        inline O drain(O out) noexcept {
+            while (auto tmp_ { try_poll() }) *out++ = std::move(*tmp_);
+
+            return out;
+        }
+
+        inline stats_snapshot stats(void) const noexcept { return m_stats.snapshot(); }
+
+        inline bool try_push(const T& v)                      noexcept { return try_emplace(v); }
+        inline bool try_push(std::convertible_to<T> auto&& v) noexcept { return try_emplace(std::forward<decltype(v)>(v)); }
+
+        inline std::optional<T> try_poll(void) noexcept {
+            std::optional<T> tmp_;
+            try_consume([&tmp_](T&& v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
+
+        template <std::invocable<T&&> F>
+        inline bool try_consume(F&& f) noexcept {
+            auto const tail_ { m_tail.load(std::memory_order::relaxed) & ~m_closed_bit };
+            if (tail_ == m_cached_head) {
+                m_cached_head = m_head.load(std::memory_order::acquire) & ~m_closed_bit;
+                if (tail_ == m_cached_head) return false;
+            }
+
+            return take(tail_, std::forward<F>(f));
+        }
+
+        /* @brief: Poll with a deadline, waits on the head with ubn::wait_until between attempts, close() changes the head too */
+        template <typename Clock, typename Duration>
+        inline std::optional<T> poll_until(const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+            while (true) {
+                if (auto tmp_ { try_poll() }; tmp_.has_value()) return tmp_;
+
+                auto const head_ { m_head.load(std::memory_order::seq_cst) };
+                if ((head_ & ~m_closed_bit) != (m_tail.load(std::memory_order::relaxed) & ~m_closed_bit)) continue;
+                if (m_closed.load(std::memory_order::seq_cst) || !wait_until(m_head, head_, deadline)) return std::nullopt;
+            }
+        }
+
+        template <typename Rep, typename Period>
+        inline std::optional<T> poll_for(const std::chrono::duration<Rep, Period>& timeout) noexcept {
+            return poll_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        /*
+         * @brief: Push all items of a sized range, the head index is published once per batch or whenever the ring fills up
+         */
+        template <std::ranges::sized_range R> requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+        inline bool push_bulk(R&& r) noexcept {
+            if (closed()) return false;
+
+            auto head_ { m_head.load(std::memory_order::relaxed) & ~m_closed_bit };
+            for (auto&& v : r) {
+                auto const next_ { m_next(head_) };
+                if (next_ == m_cached_tail) {
+                    publish_head(head_);
+                    if (!wait_tail(next_)) return false;
+                }
+                new (&m_containers[head_]) T(std::forward<decltype(v)>(v));
+                pushed(next_);
+                head_ = next_;
+            }
+            publish_head(head_);
+
+            return true;
+        }
+
+        /*
+         * @brief: Poll n items into an output iterator, the tail index is published once per batch or whenever the ring drains
+         */
+        template <std::output_iterator<T> O>
+        inline O poll_bulk(O out, const std::size_t n) noexcept {
+            auto tail_ { m_tail.load(std::memory_order::relaxed) & ~m_closed_bit };
+            for ([[maybe_unused]] auto i : std::views::iota(0ul, n)) {
+                if (tail_ == m_cached_head) {
+                    publish_tail(tail_);
+                    if (!wait_head(tail_)) break;
+                }
+                auto* p_ { reinterpret_cast<T*>(&m_containers[tail_]) };
+                *out++ = std::move(*p_);
+                p_->~T();
+                m_stats.polled();
+                tail_ = m_next(tail_);
+            }
+            publish_tail(tail_);
+
+            return out;
+        }
+
+    protected:
+        using container = typename std::aligned_storage<sizeof(T), std::max(alignof(T), Policy::layout::alignment)>::type;
+
+        template <typename... Args>
+        inline bool emplace(Args&&... args) noexcept {
+            if (closed()) return false;
+
+            auto const head_ { m_head.load(std::memory_order::relaxed) & ~m_closed_bit };
+            auto const next_ { m_next(head_) };
+            if (next_ == m_cached_tail && !wait_tail(next_)) return false;
+            new (&m_containers[head_]) T(std::forward<Args>(args)...);
+            publish_head(next_);
+            pushed(next_);
+
+            return true;
+        }
+
+        template <typename... Args>
+        inline bool try_emplace(Args&&... args) noexcept {
+            if (closed()) return false;
+
+            auto const head_ { m_head.load(std::memory_order::relaxed) & ~m_closed_bit };
+            auto const next_ { m_next(head_) };
+            if (next_ == m_cached_tail) {
+                m_cached_tail = m_tail.load(std::memory_order::acquire) & ~m_closed_bit;
+                if (next_ == m_cached_tail) return false;
+            }
+            new (&m_containers[head_]) T(std::forward<Args>(args)...);
+            publish_head(next_);
+            pushed(next_);
+
+            return true;
+        }
+
+        inline std::optional<T> take(const std::size_t tail_) noexcept {
+            std::optional<T> tmp_;
+            take(tail_, [&tmp_](T&& v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
+
+        template <typename F>
+        inline bool take(const std::size_t tail_, F&& f) noexcept {
+            auto* p_ { reinterpret_cast<T*>(&m_containers[tail_]) };
+            std::invoke(std::forward<F>(f), std::move(*p_));
+            p_->~T();
+            publish_tail(m_next(tail_));
+            m_stats.polled();
+
+            return true;
+        }
+
+        /*
+         * @brief:  Wait until the tail moves past the next head, gives up once the queue is closed, like wait_head()
+         * @return: bool, false if the producer gave up
+         */
+        inline bool wait_tail(const std::size_t next_) noexcept {
+            if ((m_cached_tail = m_tail.load(std::memory_order::acquire) & ~m_closed_bit) != next_) return true;
+
+            auto const since_ { blocked_since<typename Policy::stats>() };
+            auto       ready_ { true };
+            while (true) {
+                auto const tail_ { m_tail.load(std::memory_order::seq_cst) };
+                if ((m_cached_tail = tail_ & ~m_closed_bit) != next_) break;
+                if (m_closed.load(std::memory_order::seq_cst)) {
+                    ready_ = false;
+                    break;
+                }
+                m_stats.waited();
+                Policy::wait_strategy::wait(m_tail, tail_);
+            }
+            m_stats.push_blocked(blocked_for<typename Policy::stats>(since_));
+
+            return ready_;
+        }
+
+        /*
+         * @brief:  Wait until the head moves past the tail, gives up once the queue is closed and empty
+         * @return: bool, false if the consumer gave up
+         * @note:   The head and the flag are loaded seq_cst, either the flag is seen or the bit close() sets in the head changes the value
+         *          that is waited on
+         */
+        inline bool wait_head(const std::size_t tail_) noexcept {
+            if (tail_ != m_cached_head || (m_cached_head = m_head.load(std::memory_order::acquire) & ~m_closed_bit) != tail_) return true;
+
+            auto const since_ { blocked_since<typename Policy::stats>() };
+            auto       ready_ { true };
+            while (true) {
+                auto const head_ { m_head.load(std::memory_order::seq_cst) };
+                if ((m_cached_head = head_ & ~m_closed_bit) != tail_) break;
+                if (m_closed.load(std::memory_order::seq_cst)) {
+                    ready_ = false;
+                    break;
+                }
+                m_stats.waited();
+                Policy::wait_strategy::wait(m_head, head_);
+            }
+            m_stats.poll_blocked(blocked_for<typename Policy::stats>(since_));
+
+            return ready_;
+        }
+
+        inline void pushed(const std::size_t next_) noexcept {
+            if constexpr (Policy::stats::enabled) {
+                auto const tail_ { m_tail.load(std::memory_order::relaxed) & ~m_closed_bit };
+                m_stats.pushed(next_ >= tail_ ? next_ - tail_ : next_ + m_capacity - tail_);
+            }
+        }
+
+        inline void publish_head(const std::size_t head_) noexcept {
+            m_head.store(static_cast<std::uint32_t>(head_), std::memory_order::release);
+            Policy::wait_strategy::notify(m_head);
+        }
+
+        inline void publish_tail(const std::size_t tail_) noexcept {
+            m_tail.store(static_cast<std::uint32_t>(tail_), std::memory_order::release);
+            Policy::wait_strategy::notify(m_tail);
+        }
+
+    private:
+        constexpr std::size_t m_next(const std::size_t i) const noexcept { return i + 1 == m_capacity ? 0 : i + 1; }
+
+        container*                m_containers;
+        std::size_t const         m_capacity;
+        std::allocator<container> m_allocator [[no_unique_address]];
+        typename Policy::stats    m_stats     [[no_unique_address]];
+
+        static constexpr std::uint32_t m_closed_bit { std::uint32_t { 1 } << 31 };
+
+        alignas(hardware_destructive_interference_size) std::atomic_bool             m_closed { false };
+        alignas(hardware_destructive_interference_size) std::atomic_uint32_t mutable m_head;
+                                                        std::size_t                  m_cached_tail;
+        alignas(hardware_destructive_interference_size) std::atomic_uint32_t mutable m_tail;
+                                                        std::size_t                  m_cached_head;
+    };
+}
+
+#ifndef UBN_QUEUE_NAMESPACED
+namespace ubn {
+    using atomic_limited::queue;
 }
+#endif
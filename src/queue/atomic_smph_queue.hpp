@@ -1,70 +1,227 @@
 #pragma once
 
 #include <queue>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <functional>
 
 #include <atomic>
+#include <chrono>
 #include <semaphore>
 
 #include <cstdint>
 #include <cstddef>
 
+#include <iterator>
 #include <concepts>
 #include <optional>
 
-namespace ubn
+#include "../utilities/interference_size.hpp"
+
+#include "queue_stats.hpp"
+
+namespace ubn::atomic_smph
 {
-    template <typename T>
+    template <typename T, typename Allocator = std::allocator<T>, typename Stats = no_stats>
     class queue
     {
     public:
-        inline explicit queue(void) {}
+        inline explicit queue(const Allocator &allocator = Allocator()) : m_data{std::deque<T, Allocator>(allocator)} {}
 
         inline ~queue(void) noexcept {}
 
         inline queue &operator=(const queue &) = delete;
 
-        inline void push(const T &v) noexcept
+        /*
+         * @brief:  Push an item, fails once the queue has been closed
+         * @return: bool, whether the item has been pushed
+         */
+        inline bool push(const T &v) noexcept
         {
             lock_();
+            if (m_closed.load(std::memory_order::relaxed))
+            {
+                unlock_();
+                return false;
+            }
             m_data.emplace(v);
+            m_stats.pushed(m_data.size());
+            m_size.store(m_data.size(), std::memory_order::relaxed);
             unlock_();
 
             m_avaliable.release();
+
+            return true;
         }
 
-        inline void push(std::convertible_to<T> auto &&v) noexcept
+        inline bool push(std::convertible_to<T> auto &&v) noexcept
         {
             lock_();
+            if (m_closed.load(std::memory_order::relaxed))
+            {
+                unlock_();
+                return false;
+            }
             m_data.emplace(std::forward<decltype(v)>(v));
+            m_stats.pushed(m_data.size());
+            m_size.store(m_data.size(), std::memory_order::relaxed);
             unlock_();
 
             m_avaliable.release();
+
+            return true;
         }
 
-        inline T poll(void) noexcept
+        /*
+         * @brief:  Poll an item, blocks on the semaphore while the queue is empty and open
+         * @return: std::optional<T>, the polled item or std::nullopt once the queue is closed and empty
+         */
+        inline std::optional<T> poll(void) noexcept
         {
             std::optional<T> tmp_;
+            consume([&tmp_](T &&v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
+
+        /*
+         * @brief:  Poll an item into an existing object, move-assigned straight from the front of the queue
+         * @return: bool, false once the queue is closed and empty
+         */
+        inline bool poll(T &out) noexcept
+        {
+            return consume([&out](T &&v) { out = std::move(v); });
+        }
+
+        /*
+         * @brief:  Poll an item and visit it in place, the visitor runs under the ticket lock so keep it short
+         * @param:  F&&, invocable with T&&, may move from the item or only read it
+         * @return: bool, false once the queue is closed and empty
+         */
+        template <std::invocable<T &&> F>
+        inline bool consume(F &&f) noexcept
+        {
+            while (true)
+            {
+                if (!m_avaliable.try_acquire())
+                {
+                    auto const since_{blocked_since<Stats>()};
+                    m_stats.waited();
+                    m_avaliable.acquire();
+                    m_stats.poll_blocked(blocked_for<Stats>(since_));
+                }
+
+                if (take_(f))
+                    return true;
+                if (m_closed.load(std::memory_order::acquire))
+                    return false;
+            }
+        }
+
+        template <typename Clock, typename Duration>
+        inline std::optional<T> poll_until(const std::chrono::time_point<Clock, Duration> &deadline) noexcept
+        {
+            std::optional<T> tmp_;
+            auto const emplace_{[&tmp_](T &&v) { tmp_.emplace(std::move(v)); }};
+
+            while (true)
+            {
+                if (!m_avaliable.try_acquire())
+                {
+                    auto const since_{blocked_since<Stats>()};
+                    m_stats.waited();
+                    auto const acquired_{m_avaliable.try_acquire_until(deadline)};
+                    m_stats.poll_blocked(blocked_for<Stats>(since_));
+                    if (!acquired_)
+                        break;
+                }
 
-            m_avaliable.acquire();
+                if (take_(emplace_) || m_closed.load(std::memory_order::acquire))
+                    break;
+            }
+
+            return tmp_;
+        }
 
+        template <typename Rep, typename Period>
+        inline std::optional<T> poll_for(const std::chrono::duration<Rep, Period> &timeout) noexcept
+        {
+            return poll_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        /*
+         * @brief: Close the queue, pushes fail from now on and every blocked poll wakes up, items already queued can still be polled
+         *         - a single extra permit is released, a poll that finds the queue closed and empty hands it on to the next one
+         */
+        inline void close(void) noexcept
+        {
             lock_();
-            tmp_ = std::move(m_data.front());
-            m_data.pop();
+            auto const closed_{m_closed.exchange(true, std::memory_order::release)};
             unlock_();
 
-            return std::move(*tmp_);
+            if (!closed_)
+                m_avaliable.release();
         }
 
-        inline std::size_t size(void) noexcept
+        inline bool closed(void) const noexcept { return m_closed.load(std::memory_order::acquire); }
+
+        /*
+         * @brief:  Move out all remaining items under a single lock, then takes back their permits
+         * @param:  O, output iterator receiving the items in FIFO order
+         * @return: O, the output iterator past the last written item
+         */
+        template <std::output_iterator<T> O>
+        inline O drain(O out) noexcept
         {
+            std::size_t n_{0};
+
             lock_();
-            const std::size_t tmp_{m_data.size()};
+            for (; !m_data.empty(); ++n_)
+            {
+                *out++ = std::move(m_data.front());
+                m_data.pop();
+                m_stats.polled();
+            }
+            m_size.store(0, std::memory_order::relaxed);
             unlock_();
 
-            return std::move(tmp_);
+            while (n_-- && m_avaliable.try_acquire())
+                ;
+
+            return out;
         }
 
+        inline stats_snapshot stats(void) const noexcept { return m_stats.snapshot(); }
+
+        /* @brief: Item count mirrored under the ticket lock on every change, read without taking it, a snapshot that may be stale */
+        inline std::size_t size(void) const noexcept { return m_size.load(std::memory_order::relaxed); }
+
     protected:
+        /*
+         * @brief: Visit the front item after acquiring a permit, the queue may be empty if a drain raced the permit or it has been closed
+         */
+        template <typename F>
+        inline bool take_(F &&f) noexcept
+        {
+            lock_();
+            auto const taken_{!m_data.empty()};
+            if (taken_)
+            {
+                std::invoke(std::forward<F>(f), std::move(m_data.front()));
+                m_data.pop();
+                m_size.store(m_data.size(), std::memory_order::relaxed);
+            }
+            unlock_();
+
+            if (taken_)
+                m_stats.polled();
+            else if (m_closed.load(std::memory_order::acquire))
+                m_avaliable.release();
+
+            return taken_;
+        }
+
         inline void lock_(void) noexcept
         {
             auto const ticket_{m_in.fetch_add(1, std::memory_order::acquire)};
@@ -73,6 +230,7 @@ namespace ubn
                 auto const now_{m_out.load(std::memory_order::acquire)};
                 if (now_ == ticket_)
                     return;
+                m_stats.waited();
                 m_out.wait(now_, std::memory_order::relaxed);
             }
         }
@@ -84,13 +242,22 @@ namespace ubn
         }
 
     private:
-        std::queue<T> m_data;
+        std::queue<T, std::deque<T, Allocator>> m_data;
 
-        std::counting_semaphore<SSIZE_MAX> m_avaliable{0};
+        std::counting_semaphore<> m_avaliable{0};
+        std::atomic<bool> m_closed{false};
+        std::atomic<std::size_t> m_size{0};
 
-        static constexpr std::size_t hardware_destructive_interference_size{2 * sizeof(std::max_align_t)};
+        [[no_unique_address]] Stats m_stats;
 
         alignas(hardware_destructive_interference_size) mutable std::atomic<std::size_t> m_in;
         alignas(hardware_destructive_interference_size) mutable std::atomic<std::size_t> m_out;
     };
 }
+
+#ifndef UBN_QUEUE_NAMESPACED
+namespace ubn
+{
+    using atomic_smph::queue;
+}
+#endif
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+
+#include <memory>
+#include <vector>
+
+#include <bit>
+
+#include <cstdint>
+#include <cstddef>
+
+#include <optional>
+#include <type_traits>
+
+#include "../utilities/interference_size.hpp"
+
+namespace ubn {
+    /*
+     * @brief: Chase-Lev work-stealing deque (Le, Pop, Cohen, Nardelli 2013, C11 memory model version)
+     *         - the owner thread pushes and pops at the bottom, LIFO
+     *         - any other thread steals from the top, FIFO, a steal losing a race returns std::nullopt
+     *         - the ring grows by doubling on a full push, old rings are kept until destruction since thieves may still read them
+     * @param: typename, trivially copyable item, usually a pointer to a task
+     */
+    template <typename T>
+    class ws_deque {
+    public:
+        static_assert(std::is_trivially_copyable_v<T>, "ws_deque requires trivially copyable items");
+
+        inline explicit ws_deque(const std::size_t capacity = 256) :
+            m_top    { 0 },
+            m_bottom { 0 } {
+
+            m_rings.push_back(std::make_unique<ring>(std::bit_ceil(capacity ? capacity : 1)));
+            m_ring.store(m_rings.back().get(), std::memory_order::relaxed);
+        }
+
+        inline ws_deque           (const ws_deque&) = delete;
+        inline ws_deque &operator=(const ws_deque&) = delete;
+
+        /* @brief: Push an item at the bottom, owner thread only */
+        inline void push(const T v) {
+            auto const bottom_ { m_bottom.load(std::memory_order::relaxed) };
+            auto const top_    { m_top.load(std::memory_order::acquire) };
+            auto*      ring_   { m_ring.load(std::memory_order::relaxed) };
+            if (bottom_ - top_ > static_cast<std::int64_t>(ring_->m_mask)) ring_ = grow(ring_, top_, bottom_);
+
+            ring_->put(bottom_, v);
+            std::atomic_thread_fence(std::memory_order::release);
+            m_bottom.store(bottom_ + 1, std::memory_order::relaxed);
+        }
+
+        /* @brief: Pop the most recently pushed item, owner thread only */
+        inline std::optional<T> pop(void) noexcept {
+            auto const bottom_ { m_bottom.load(std::memory_order::relaxed) - 1 };
+            auto*      ring_   { m_ring.load(std::memory_order::relaxed) };
+            m_bottom.store(bottom_, std::memory_order::relaxed);
+            std::atomic_thread_fence(std::memory_order::seq_cst);
+            auto       top_    { m_top.load(std::memory_order::relaxed) };
+
+            std::optional<T> tmp_;
+            if (top_ <= bottom_) {
+                tmp_ = ring_->get(bottom_);
+                if (top_ == bottom_) {
+                    if (!m_top.compare_exchange_strong(top_, top_ + 1, std::memory_order::seq_cst, std::memory_order::relaxed)) tmp_.reset();
+                    m_bottom.store(bottom_ + 1, std::memory_order::relaxed);
+                }
+            } else {
+                m_bottom.store(bottom_ + 1, std::memory_order::relaxed);
+            }
+
+            return tmp_;
+        }
+
+        /* @brief: Steal the oldest item, any thread */
+        inline std::optional<T> steal(void) noexcept {
+            auto       top_    { m_top.load(std::memory_order::acquire) };
+            std::atomic_thread_fence(std::memory_order::seq_cst);
+            auto const bottom_ { m_bottom.load(std::memory_order::acquire) };
+            if (top_ >= bottom_) return std::nullopt;
+
+            auto const tmp_ { m_ring.load(std::memory_order::acquire)->get(top_) };
+            if (!m_top.compare_exchange_strong(top_, top_ + 1, std::memory_order::seq_cst, std::memory_order::relaxed)) return std::nullopt;
+
+            return tmp_;
+        }
+
+        inline std::size_t size(void) const noexcept {
+            auto const size_ { m_bottom.load(std::memory_order::relaxed) - m_top.load(std::memory_order::relaxed) };
+
+            return size_ > 0 ? static_cast<std::size_t>(size_) : 0;
+        }
+
+    protected:
+        struct ring {
+        public:
+            inline explicit ring(const std::size_t capacity) : m_mask { capacity - 1 }, m_items { new std::atomic<T>[capacity] } {}
+
+            inline void put(const std::int64_t i, const T v) noexcept { m_items[static_cast<std::size_t>(i) & m_mask].store(v, std::memory_order::relaxed); }
+            inline T    get(const std::int64_t i) const noexcept      { return m_items[static_cast<std::size_t>(i) & m_mask].load(std::memory_order::relaxed); }
+
+            std::size_t const                 m_mask;
+            std::unique_ptr<std::atomic<T>[]> m_items;
+        };
+
+        inline ring* grow(ring* ring_, const std::int64_t top_, const std::int64_t bottom_) {
+            m_rings.push_back(std::make_unique<ring>(2 * (ring_->m_mask + 1)));
+            auto* grown_ { m_rings.back().get() };
+            for (auto i { top_ }; i != bottom_; ++i) grown_->put(i, ring_->get(i));
+            m_ring.store(grown_, std::memory_order::release);
+
+            return grown_;
+        }
+
+    private:
+        alignas(hardware_destructive_interference_size) std::atomic_int64_t                m_top;
+        alignas(hardware_destructive_interference_size) std::atomic_int64_t                m_bottom;
+        alignas(hardware_destructive_interference_size) std::atomic<ring*>                 m_ring;
+                                                        std::vector<std::unique_ptr<ring>> m_rings;
+    };
+}
@@ -0,0 +1,196 @@
+/*
+ Note:
+    - compares every ubn::queue implementation side by side, each header is included with UBN_QUEUE_NAMESPACED
+    - sweeps producer/consumer counts, payload sizes and capacities (bounded queues only)
+    - reports throughput, p50/p99/p999 enqueue-to-dequeue latency and context switches (voluntary + involuntary)
+    - cv::Mat header payload is only benchmarked when OpenCV is available
+    - layout mode compares the packed, padded and padded_pair slot layouts of the ticket queue under contention
+    - usage: ./<binary> [items per run, default 65536] [sweep|layout, default sweep]
+ */
+
+#define UBN_QUEUE_NAMESPACED
+
+#include "atomic_queue_limited.hpp"
+#include "atomic_smph_queue.hpp"
+#include "atomic_linked_queue.hpp"
+#include "mutex_cv_queue.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <array>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#include <sys/resource.h>
+
+#if __has_include(<opencv2/core/mat.hpp>)
+#include <opencv2/core/mat.hpp>
+#define HAS_OPENCV_MAT
+#endif
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename P>
+struct item {
+    clock_type::time_point m_stamp;
+    P                      m_payload;
+};
+
+template <std::size_t N>
+using bytes = std::array<std::byte, N>;
+
+struct result {
+    double m_throughput;
+    double m_p50;
+    double m_p99;
+    double m_p999;
+    long   m_context_switches;
+};
+
+static inline long context_switches(void) {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+template <typename P>
+static inline P make_payload(void) {
+#ifdef HAS_OPENCV_MAT
+    if constexpr (std::is_same_v<P, cv::Mat>) {
+        static const cv::Mat frame(480, 640, CV_8UC3);
+        return frame;
+    } else
+#endif
+    return P {};
+}
+
+template <typename Q, typename P>
+static inline result run(Q& q, const std::size_t producers, const std::size_t consumers, const std::size_t items) {
+    auto const per_producer_ { items / producers };
+    auto const total_        { per_producer_ * producers };
+
+    std::vector<std::vector<double>> latencies_(consumers);
+    std::vector<std::thread>         threads_;
+    std::atomic_bool                 start_ { false };
+
+    auto const switches_ { context_switches() };
+    for (std::size_t c { 0 }; c != consumers; ++c) {
+        auto const n_ { total_ / consumers + (c < total_ % consumers) };
+        latencies_[c].reserve(n_);
+        threads_.emplace_back([&, c, n_] {
+            start_.wait(false);
+            for (std::size_t i { 0 }; i != n_; ++i) {
+                auto const v_ { q.poll() };
+                latencies_[c].push_back(std::chrono::duration<double, std::nano>(clock_type::now() - v_->m_stamp).count());
+            }
+        });
+    }
+    for (std::size_t p { 0 }; p != producers; ++p) {
+        threads_.emplace_back([&] {
+            auto const payload_ { make_payload<P>() };
+            start_.wait(false);
+            for (std::size_t i { 0 }; i != per_producer_; ++i) q.push(item<P> { clock_type::now(), payload_ });
+        });
+    }
+
+    auto const begin_ { clock_type::now() };
+    start_.store(true);
+    start_.notify_all();
+    for (auto& thread : threads_) thread.join();
+    auto const end_ { clock_type::now() };
+
+    std::vector<double> merged_;
+    merged_.reserve(total_);
+    for (auto const& l : latencies_) merged_.insert(merged_.end(), l.begin(), l.end());
+    auto const percentile_ { [&](const double q_) {
+        auto it_ { merged_.begin() + static_cast<std::ptrdiff_t>(q_ * (merged_.size() - 1)) };
+        std::nth_element(merged_.begin(), it_, merged_.end());
+        return *it_;
+    } };
+
+    return {
+        total_ / std::chrono::duration<double>(end_ - begin_).count(),
+        percentile_(0.5),
+        percentile_(0.99),
+        percentile_(0.999),
+        context_switches() - switches_
+    };
+}
+
+static inline void report(const char* name, const char* payload, const std::size_t capacity, const std::size_t producers, const std::size_t consumers, const result& r) {
+    auto const capacity_ { capacity ? std::to_string(capacity) : std::string("-") };
+    std::printf("%-16s %-8s %8s %3zu:%-3zu %14.0f %12.0f %12.0f %12.0f %10ld\n",
+        name, payload, capacity_.c_str(), producers, consumers, r.m_throughput, r.m_p50, r.m_p99, r.m_p999, r.m_context_switches);
+}
+
+template <typename P>
+static inline void sweep(const char* payload, const std::size_t items) {
+    static constexpr std::array<std::size_t, 3> threads    { 1, 2, 4 };
+    static constexpr std::array<std::size_t, 3> capacities { 64, 1024, 65535 };
+
+    for (auto producers : threads) for (auto consumers : threads) {
+        for (auto capacity : capacities) {
+            ubn::atomic_limited::queue<item<P>> q(capacity);
+            report("atomic_limited", payload, capacity, producers, consumers, run<decltype(q), P>(q, producers, consumers, items));
+        }
+        if (producers == 1 && consumers == 1) for (auto capacity : capacities) {
+            ubn::atomic_limited::queue<item<P>, ubn::spsc> q(capacity);
+            report("atomic_spsc", payload, capacity, producers, consumers, run<decltype(q), P>(q, producers, consumers, items));
+        }
+        {
+            ubn::atomic_smph::queue<item<P>> q;
+            report("atomic_smph", payload, 0, producers, consumers, run<decltype(q), P>(q, producers, consumers, items));
+        }
+        {
+            ubn::atomic_linked::queue<item<P>> q;
+            report("atomic_linked", payload, 0, producers, consumers, run<decltype(q), P>(q, producers, consumers, items));
+        }
+        {
+            ubn::mutex_cv::queue<item<P>> q;
+            report("mutex_cv", payload, 0, producers, consumers, run<decltype(q), P>(q, producers, consumers, items));
+        }
+    }
+}
+
+template <typename Layout>
+struct layout_policy : ubn::mpmc { using layout = Layout; };
+
+template <typename Layout>
+static inline void sweep_layout(const char* name, const std::size_t items) {
+    static constexpr std::array<std::size_t, 4> threads    { 1, 2, 4, 8 };
+    static constexpr std::array<std::size_t, 2> capacities { 64, 1024 };
+
+    for (auto n : threads) for (auto capacity : capacities) {
+        ubn::atomic_limited::queue<item<int>, layout_policy<Layout>> q(capacity);
+        report(name, "int", capacity, n, n, run<decltype(q), int>(q, n, n, items));
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t items { argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 65536 };
+    const std::string mode  { argc > 2 ? argv[2] : "sweep" };
+
+    std::printf("%-16s %-8s %8s %7s %14s %12s %12s %12s %10s\n",
+        "queue", "payload", "capacity", "p:c", "items/s", "p50(ns)", "p99(ns)", "p999(ns)", "ctx-sw");
+
+    if (mode == "layout") {
+        sweep_layout<ubn::packed>     ("packed",      items);
+        sweep_layout<ubn::padded>     ("padded",      items);
+        sweep_layout<ubn::padded_pair>("padded_pair", items);
+
+        return 0;
+    }
+
+    sweep<int>        ("int",     items);
+    sweep<bytes<64>>  ("64B",     items);
+    sweep<bytes<4096>>("4KB",     items);
+#ifdef HAS_OPENCV_MAT
+    sweep<cv::Mat>    ("cv::Mat", items);
+#endif
+
+    return 0;
+}
@@ -1,49 +1,174 @@
 #pragma once
 
 #include <queue>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <functional>
+
+#include <chrono>
 
 #include <mutex>
 #include <condition_variable>
 
+#include <iterator>
 #include <concepts>
 #include <optional>
 
-namespace ubn
+#include "queue_stats.hpp"
+
+namespace ubn::mutex_cv
 {
 
-    template <typename T>
+    template <typename T, typename Allocator = std::allocator<T>, typename Stats = no_stats>
     class queue
     {
     public:
-        inline explicit queue(void) : m_data{}, m_mutex{}, m_cv{} {}
+        inline explicit queue(const Allocator &allocator = Allocator()) : m_data{std::deque<T, Allocator>(allocator)} {}
 
         inline ~queue(void) noexcept {}
 
         inline queue &operator=(const queue &) = delete;
 
-        inline void push(std::convertible_to<T> auto &&v) noexcept
+        /*
+         * @brief:  Push an item, fails once the queue has been closed
+         * @return: bool, whether the item has been pushed
+         */
+        inline bool push(std::convertible_to<T> auto &&v) noexcept
         {
             std::lock_guard<std::mutex> lock_(m_mutex);
+            if (m_closed)
+                return false;
 
             m_data.emplace(std::forward<decltype(v)>(v));
+            m_stats.pushed(m_data.size());
             m_cv.notify_one();
+
+            return true;
+        }
+
+        /*
+         * @brief:  Poll an item, blocks while the queue is empty and open
+         * @return: std::optional<T>, the polled item or std::nullopt once the queue is closed and empty
+         */
+        inline std::optional<T> poll(void) noexcept
+        {
+            std::optional<T> tmp_;
+            consume([&tmp_](T &&v) { tmp_.emplace(std::move(v)); });
+
+            return tmp_;
+        }
+
+        /*
+         * @brief:  Poll an item into an existing object, move-assigned straight from the front of the queue
+         * @return: bool, false once the queue is closed and empty
+         */
+        inline bool poll(T &out) noexcept
+        {
+            return consume([&out](T &&v) { out = std::move(v); });
         }
 
-        inline T poll(void) noexcept
+        /*
+         * @brief:  Poll an item and visit it in place, the visitor runs under the mutex so keep it short
+         * @param:  F&&, invocable with T&&, may move from the item or only read it
+         * @return: bool, false once the queue is closed and empty
+         */
+        template <std::invocable<T &&> F>
+        inline bool consume(F &&f) noexcept
+        {
+            std::unique_lock<std::mutex> lock_(m_mutex);
+            if (m_data.empty() && !m_closed)
+            {
+                auto const since_{blocked_since<Stats>()};
+                while (m_data.empty() && !m_closed)
+                {
+                    m_stats.waited();
+                    m_cv.wait(lock_);
+                }
+                m_stats.poll_blocked(blocked_for<Stats>(since_));
+            }
+            if (m_data.empty())
+                return false;
+
+            std::invoke(std::forward<F>(f), std::move(m_data.front()));
+            m_data.pop();
+            m_stats.polled();
+
+            return true;
+        }
+
+        template <typename Clock, typename Duration>
+        inline std::optional<T> poll_until(const std::chrono::time_point<Clock, Duration> &deadline) noexcept
         {
             std::optional<T> tmp_;
             std::unique_lock<std::mutex> lock_(m_mutex);
-            while (m_data.empty())
+            if (m_data.empty() && !m_closed)
             {
-                m_cv.wait(lock_);
+                auto const since_{blocked_since<Stats>()};
+                while (m_data.empty() && !m_closed)
+                {
+                    m_stats.waited();
+                    if (m_cv.wait_until(lock_, deadline) == std::cv_status::timeout)
+                        break;
+                }
+                m_stats.poll_blocked(blocked_for<Stats>(since_));
             }
+            if (m_data.empty())
+                return std::nullopt;
 
-            tmp_ = std::move(m_data.front());
+            tmp_.emplace(std::move(m_data.front()));
             m_data.pop();
+            m_stats.polled();
+
+            return tmp_;
+        }
+
+        template <typename Rep, typename Period>
+        inline std::optional<T> poll_for(const std::chrono::duration<Rep, Period> &timeout) noexcept
+        {
+            return poll_until(std::chrono::steady_clock::now() + timeout);
+        }
+
+        /*
+         * @brief: Close the queue, pushes fail from now on and every blocked poll wakes up, items already queued can still be polled
+         */
+        inline void close(void) noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock_(m_mutex);
+                m_closed = true;
+            }
+            m_cv.notify_all();
+        }
+
+        inline bool closed(void) const noexcept
+        {
+            std::lock_guard<std::mutex> lock_(m_mutex);
+
+            return m_closed;
+        }
 
-            return std::move(*tmp_);
+        /*
+         * @brief:  Move out all remaining items under a single lock
+         * @param:  O, output iterator receiving the items in FIFO order
+         * @return: O, the output iterator past the last written item
+         */
+        template <std::output_iterator<T> O>
+        inline O drain(O out) noexcept
+        {
+            std::lock_guard<std::mutex> lock_(m_mutex);
+            while (!m_data.empty())
+            {
+                *out++ = std::move(m_data.front());
+                m_data.pop();
+                m_stats.polled();
+            }
+
+            return out;
         }
 
+        inline stats_snapshot stats(void) const noexcept { return m_stats.snapshot(); }
+
         inline std::size_t size(void) noexcept
         {
             std::unique_lock<std::mutex> lock_(m_mutex);
@@ -52,10 +177,21 @@ namespace ubn
         }
 
     private:
-        std::queue<T> m_data;
+        std::queue<T, std::deque<T, Allocator>> m_data;
 
         std::mutex mutable m_mutex;
         std::condition_variable mutable m_cv;
+
+        bool m_closed{false};
+
+        [[no_unique_address]] Stats m_stats;
     };
 
 }
+
+#ifndef UBN_QUEUE_NAMESPACED
+namespace ubn
+{
+    using mutex_cv::queue;
+}
+#endif
@@ -0,0 +1,112 @@
+/*
+ Note:
+    - compile-time gated instrumentation policies for the ubn queue templates
+        - no_stats:    default, every hook is an empty inline function and no clock is read
+        - queue_stats: counts pushes, polls and wait() calls, tracks the occupancy high-water mark and the time spent blocked in push and poll
+    - queue_stats keeps its counters in cache line aligned shards, each thread updates the shard it was assigned on first use,
+      so the counters are not a contention point of their own, snapshot() sums the shards
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include <array>
+
+#include <cstdint>
+#include <cstddef>
+
+#include "../utilities/interference_size.hpp"
+
+namespace ubn {
+    struct stats_snapshot {
+        std::uint64_t            m_pushes       { 0 };
+        std::uint64_t            m_polls        { 0 };
+        std::uint64_t            m_waits        { 0 };
+        std::uint64_t            m_high_water   { 0 };
+        std::chrono::nanoseconds m_push_blocked { 0 };
+        std::chrono::nanoseconds m_poll_blocked { 0 };
+    };
+
+    struct no_stats {
+        static constexpr bool enabled { false };
+
+        inline void pushed      (const std::size_t)              noexcept {}
+        inline void polled      (void)                           noexcept {}
+        inline void waited      (void)                           noexcept {}
+        inline void push_blocked(const std::chrono::nanoseconds) noexcept {}
+        inline void poll_blocked(const std::chrono::nanoseconds) noexcept {}
+
+        inline stats_snapshot snapshot(void) const noexcept { return {}; }
+    };
+
+    template <const std::size_t Shards = 32>
+    struct sharded_stats {
+    public:
+        static constexpr bool enabled { true };
+
+        /* @param: const std::size_t, the occupancy right after the push, feeds the high-water mark */
+        inline void pushed(const std::size_t occupancy) noexcept {
+            auto& shard_ { local() };
+            shard_.m_pushes.fetch_add(1, std::memory_order::relaxed);
+
+            auto high_ { shard_.m_high_water.load(std::memory_order::relaxed) };
+            while (occupancy > high_ && !shard_.m_high_water.compare_exchange_weak(high_, occupancy, std::memory_order::relaxed));
+        }
+
+        inline void polled(void) noexcept { local().m_polls.fetch_add(1, std::memory_order::relaxed); }
+        inline void waited(void) noexcept { local().m_waits.fetch_add(1, std::memory_order::relaxed); }
+
+        inline void push_blocked(const std::chrono::nanoseconds d) noexcept { local().m_push_blocked.fetch_add(d.count(), std::memory_order::relaxed); }
+        inline void poll_blocked(const std::chrono::nanoseconds d) noexcept { local().m_poll_blocked.fetch_add(d.count(), std::memory_order::relaxed); }
+
+        inline stats_snapshot snapshot(void) const noexcept {
+            stats_snapshot tmp_;
+            for (auto const& shard_ : m_shards) {
+                tmp_.m_pushes       += shard_.m_pushes.load(std::memory_order::relaxed);
+                tmp_.m_polls        += shard_.m_polls.load(std::memory_order::relaxed);
+                tmp_.m_waits        += shard_.m_waits.load(std::memory_order::relaxed);
+                tmp_.m_push_blocked += std::chrono::nanoseconds(shard_.m_push_blocked.load(std::memory_order::relaxed));
+                tmp_.m_poll_blocked += std::chrono::nanoseconds(shard_.m_poll_blocked.load(std::memory_order::relaxed));
+                if (auto const high_ { shard_.m_high_water.load(std::memory_order::relaxed) }; high_ > tmp_.m_high_water) tmp_.m_high_water = high_;
+            }
+
+            return tmp_;
+        }
+
+    protected:
+        struct alignas(hardware_destructive_interference_size) shard {
+            std::atomic_uint64_t m_pushes       { 0 };
+            std::atomic_uint64_t m_polls        { 0 };
+            std::atomic_uint64_t m_waits        { 0 };
+            std::atomic_uint64_t m_high_water   { 0 };
+            std::atomic_int64_t  m_push_blocked { 0 };
+            std::atomic_int64_t  m_poll_blocked { 0 };
+        };
+
+        inline shard& local(void) noexcept {
+            static std::atomic_size_t       s_threads { 0 };
+            static thread_local std::size_t s_index   { s_threads.fetch_add(1, std::memory_order::relaxed) % Shards };
+            return m_shards[s_index];
+        }
+
+    private:
+        std::array<shard, Shards> m_shards;
+    };
+
+    using queue_stats = sharded_stats<>;
+
+    /* @brief: Start of a blocking section, reads the clock only when the stats policy is enabled */
+    template <typename Stats>
+    inline std::chrono::steady_clock::time_point blocked_since(void) noexcept {
+        if constexpr (Stats::enabled) return std::chrono::steady_clock::now();
+        else                          return {};
+    }
+
+    template <typename Stats>
+    inline std::chrono::nanoseconds blocked_for(const std::chrono::steady_clock::time_point since) noexcept {
+        if constexpr (Stats::enabled) return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since);
+        else                          return std::chrono::nanoseconds { 0 };
+    }
+}
@@ -0,0 +1,206 @@
+/*
+ * @name: mirrored_ringbuffer.hpp
+ * @namespace: ubn
+ * @class: mirrored_ringbuffer
+ * @brief: Byte ringbuffer mapped twice back to back, variable-length records are always contiguous in virtual memory
+ * @author Unbinilium
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <span>
+#include <atomic>
+#include <cstring>
+#include <optional>
+#include <algorithm>
+#include <system_error>
+
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../utilities/interference_size.hpp"
+
+namespace ubn {
+    /*
+     * @brief: Record ringbuffer on a memfd mapped twice, one producer thread and one consumer thread
+     *         - the second mapping continues the first one, a record crossing the end of the buffer is still one contiguous range
+     *         - producer: reserve() a writable range, fill it in place, commit() the bytes actually written as one record
+     *         - consumer: read() the oldest record in place, parse it without copying, release() it to free its space
+     *         - records are framed by an 8 byte length header and padded to 8 bytes, so payloads are 8 byte aligned
+     *         - linux only, memfd_create() and mmap() with MAP_FIXED over a reserved address range
+     */
+    class mirrored_ringbuffer {
+    public:
+        /*
+         * @brief: Map the buffer, throws std::system_error if the memfd or one of the mappings fails
+         * @param: const std::size_t, the capacity in bytes, rounded up to a power of two multiple of the page size
+         */
+        inline explicit mirrored_ringbuffer(const std::size_t __capacity) {
+            auto const page_ { static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)) };
+            m_capacity = std::bit_ceil(std::max(__capacity, page_));
+
+            auto const fd_ { ::memfd_create("ubn::mirrored_ringbuffer", MFD_CLOEXEC) };
+            if (fd_ < 0) throw std::system_error(errno, std::generic_category(), "memfd_create");
+            if (::ftruncate(fd_, static_cast<off_t>(m_capacity))) fail(fd_, "ftruncate");
+
+            auto* base_ { ::mmap(nullptr, m_capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+            if (base_ == MAP_FAILED) fail(fd_, "mmap");
+            p_buffer = static_cast<std::byte*>(base_);
+
+            for (auto* p_ : { p_buffer, p_buffer + m_capacity }) {
+                if (::mmap(p_, m_capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_, 0) == MAP_FAILED) {
+                    auto const errno_ { errno };
+                    ::munmap(p_buffer, m_capacity * 2);
+                    ::close(fd_);
+                    throw std::system_error(errno_, std::generic_category(), "mmap");
+                }
+            }
+            ::close(fd_);
+        }
+
+        /* @brief: Destrutor mirrored_ringbuffer, unmaps both views */
+        inline ~mirrored_ringbuffer(void) noexcept {
+            ::munmap(p_buffer, m_capacity * 2);
+        }
+
+        /*
+         * @brief: non-copyable and non-movable
+         * @param: const mirrored_ringbuffer&
+         */
+        inline mirrored_ringbuffer(const mirrored_ringbuffer&) = delete;
+        inline mirrored_ringbuffer &operator=(const mirrored_ringbuffer&) = delete;
+
+        /*
+         * @brief:  Reserve a contiguous writable range for the next record, producer thread only, never waits
+         * @param:  const std::size_t, the maximum payload size of the record
+         * @return: std::span<std::byte>, the range to write the payload to, empty if there is not enough free space right now
+         *          or __n is larger than max_record(), use write() for empty records
+         */
+        inline std::span<std::byte> reserve(const std::size_t __n) noexcept {
+            if (!fits(__n)) {
+                m_reserved = s_none;
+                return {};
+            }
+            m_reserved = __n;
+
+            return { p_buffer + index(m_head.load(std::memory_order::relaxed)) + s_header, __n };
+        }
+
+        /*
+         * @brief:  Publish the reserved range as one record, producer thread only
+         * @param:  const std::size_t, the payload size actually written, at most the size passed to reserve()
+         * @return: bool, false and nothing is published if there is no reservation or __n is larger than it
+         */
+        inline bool commit(const std::size_t __n) noexcept {
+            if (m_reserved == s_none || __n > m_reserved) return false;
+            m_reserved = s_none;
+            publish(__n);
+
+            return true;
+        }
+
+        /*
+         * @brief:  Copy a payload in as one record, reserve(), memcpy and commit() in one call
+         * @return: bool, false if there is not enough free space right now or the payload is larger than max_record()
+         */
+        inline bool write(std::span<const std::byte> __v) noexcept {
+            if (!fits(__v.size())) return false;
+
+            if (!__v.empty()) std::memcpy(p_buffer + index(m_head.load(std::memory_order::relaxed)) + s_header, __v.data(), __v.size());
+            m_reserved = s_none;
+            publish(__v.size());
+
+            return true;
+        }
+
+        /*
+         * @brief:  View the oldest record in place, consumer thread only, stays valid until release()
+         * @return: std::optional<std::span<const std::byte>>, the payload of the record, std::nullopt if there is none
+         */
+        inline std::optional<std::span<const std::byte>> read(void) const noexcept {
+            auto const tail_ { m_tail.load(std::memory_order::relaxed) };
+            if (tail_ == m_head.load(std::memory_order::acquire)) return std::nullopt;
+
+            std::uint64_t size_;
+            std::memcpy(&size_, p_buffer + index(tail_), s_header);
+
+            return std::span<const std::byte> { p_buffer + index(tail_) + s_header, static_cast<std::size_t>(size_) };
+        }
+
+        /*
+         * @brief:  Free the record returned by read(), consumer thread only
+         * @return: bool, false and nothing is freed if there is no record
+         */
+        inline bool release(void) noexcept {
+            auto const tail_ { m_tail.load(std::memory_order::relaxed) };
+            if (tail_ == m_head.load(std::memory_order::acquire)) return false;
+
+            std::uint64_t size_;
+            std::memcpy(&size_, p_buffer + index(tail_), s_header);
+
+            m_tail.store(tail_ + framed(static_cast<std::size_t>(size_)), std::memory_order::release);
+
+            return true;
+        }
+
+        /* @brief: The capacity in bytes, record headers and padding included */
+        inline std::size_t capacity(void) const noexcept { return m_capacity; }
+
+        /* @brief: The largest payload a single record can hold */
+        inline std::size_t max_record(void) const noexcept { return m_capacity - s_header; }
+
+        /* @brief: The bytes in use, a snapshot while the other thread runs */
+        inline std::size_t size(void) const noexcept {
+            auto const tail_ { m_tail.load(std::memory_order::acquire) };
+            return m_head.load(std::memory_order::acquire) - tail_;
+        }
+
+        inline bool is_empty(void) const noexcept { return !size(); }
+
+    protected:
+        inline std::size_t index(const std::size_t __position) const noexcept { return __position & (m_capacity - 1); }
+
+        inline void publish(const std::size_t __n) noexcept {
+            auto const head_ { m_head.load(std::memory_order::relaxed) };
+            auto const size_ { static_cast<std::uint64_t>(__n) };
+            std::memcpy(p_buffer + index(head_), &size_, s_header);
+
+            m_head.store(head_ + framed(__n), std::memory_order::release);
+        }
+
+        /* @brief: Whether a record of __n bytes fits right now, checked against max_record() first so framed() cannot overflow */
+        inline bool fits(const std::size_t __n) const noexcept {
+            if (__n > max_record()) return false;
+
+            auto const head_ { m_head.load(std::memory_order::relaxed) };
+            return framed(__n) <= m_capacity - (head_ - m_tail.load(std::memory_order::acquire));
+        }
+
+        inline static std::size_t framed(const std::size_t __n) noexcept { return (s_header + __n + s_align - 1) & ~(s_align - 1); }
+
+        [[noreturn]] inline static void fail(const int __fd, const char* __what) {
+            auto const errno_ { errno };
+            ::close(__fd);
+            throw std::system_error(errno_, std::generic_category(), __what);
+        }
+
+    private:
+        static constexpr std::size_t s_header { sizeof(std::uint64_t) };
+        static constexpr std::size_t s_align  { 8 };
+        static constexpr std::size_t s_none   { static_cast<std::size_t>(-1) };
+
+        std::byte*  p_buffer   { nullptr };
+        std::size_t m_capacity { 0 };
+        std::size_t m_reserved { s_none };
+
+        alignas(hardware_destructive_interference_size) std::atomic_size_t m_head { 0 };
+        alignas(hardware_destructive_interference_size) std::atomic_size_t m_tail { 0 };
+    };
+}
@@ -10,31 +10,60 @@
 
 #pragma once
 
+#include <span>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <compare>
+#include <iterator>
 #include <utility>
+#include <optional>
+#include <algorithm>
 #include <type_traits>
 
+#include <bit>
+#include <cstddef>
+
+#include "../utilities/interference_size.hpp"
+#include "../utilities/wait_strategy.hpp"
+
 namespace ubn {
-    template<typename T, const std::size_t capacity>
+    /*
+     * @brief: Ringbuffer modes
+     *         - unsynchronized: single thread only, the default
+     *         - synchronized_spsc: one thread pushes and one thread catches, still overwrites the oldest item when full
+     */
+    struct unsynchronized {
+        static constexpr bool synchronized { false };
+    };
+
+    struct synchronized_spsc {
+        static constexpr bool synchronized { true };
+    };
+
+    template<typename T, const std::size_t capacity, typename Mode = unsynchronized>
     class ringbuffer {
     public:
         /*
-         * @brief: Initialize ringbuffer class
+         * @brief: Initialize ringbuffer class, items are stored inline and constructed only when pushed, usable in constexpr
          * @param: typename, the typename of item(s) for ringbuffer to store
-         * @param: const std::size_t, the capacity of ringbuffer, overwrites the old item(s) when pushing if ringbuffer is full
+         * @param: const std::size_t, the capacity of ringbuffer, overwrites the old item(s) when pushing if ringbuffer is full,
+         *         a power of two capacity indexes with a mask instead of a modulo
          */
-        constexpr inline ringbuffer(void) {
+        constexpr inline ringbuffer(void) noexcept {
             static_assert(capacity >= 1UL, "ringbuffer capacity < 1");
         }
         
-        /* @brief: Destrutor ringbuffer */
-        inline ~ringbuffer(void) noexcept {
-            delete[] p_buffer;
+        /* @brief: Destrutor ringbuffer, destroys the item(s) left */
+        constexpr inline ~ringbuffer(void) noexcept {
+            empty();
         }
         
         /*
          * @brief: non-copyable and non-movable
          * @param: const ringbuffer&
          */
+        constexpr inline ringbuffer(const ringbuffer&) = delete;
         constexpr inline ringbuffer &operator=(const ringbuffer&) = delete;
         
         /*
@@ -42,9 +71,8 @@ namespace ubn {
          * @param:  const T&, const lvalue reference of typename T
          * @return: bool, whether you're pushing on a full ringbuffer which performs the overwrite action on an old item
          */
-        constexpr inline bool push_head(const T& __v) noexcept {
-            p_buffer[m_position++ % capacity] = __v;
-            return is_overwrite();
+        constexpr inline bool push_head(const T& __v) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+            return emplace_head(__v);
         }
         
         /*
@@ -52,60 +80,302 @@ namespace ubn {
          * @param:  T&&, rvalue reference of typename T
          * @return: bool, whether you're pushing on a full ringbuffer which performs the overwrite action on an old item
          */
-        template<typename T_ = T>
-        constexpr inline bool push_head(T&& __v, typename std::enable_if<!std::is_reference<T_>::value, std::nullptr_t>::type = nullptr) noexcept {
-            p_buffer[m_position++ % capacity] = std::forward<T>(__v);
-            return is_overwrite();
+        constexpr inline bool push_head(T&& __v) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            return emplace_head(std::move(__v));
         }
         
         /*
-         * @brief:  Get an item from ringbuffer tail, return the default initialized type T if ringbuffer is empty, and keeps the buffer in the ringbuffer if there had no overwrite action has been performed
+         * @brief:  Constructing an new item in place on ringbuffer head, the oldest item is destroyed first if ringbuffer is full
+         * @param:  Args&&..., arguments of a constructor of typename T
+         * @return: bool, same as push_head()
+         */
+        template<typename... Args>
+        constexpr inline bool emplace_head(Args&&... __args) noexcept(std::is_nothrow_constructible_v<T, Args&&...>) {
+            auto* p_ { slot(m_head) };
+            if (m_size == capacity) {
+                std::destroy_at(p_);
+                --m_size;
+            }
+            std::construct_at(p_, std::forward<Args>(__args)...);
+            ++m_head;
+            ++m_size;
+            
+            return is_full();
+        }
+        
+        /*
+         * @brief:  Get an item from ringbuffer tail, return the default initialized type T if ringbuffer is empty, the item is moved out and destroyed in its slot
          * @return: T, the item from ringbuffer tail or the default initialed type T if ringbuffer is empty
          */
-        constexpr inline T catch_tail(void) noexcept {
-            return p_buffer[is_empty() ? capacity : (m_position + m_capacity++ - capacity) % capacity];
+        constexpr inline T catch_tail(void) {
+            if (is_empty()) return T {};
+            
+            return take_tail();
+        }
+        
+        /*
+         * @brief:  Get an item from ringbuffer tail, for T which is not default constructible
+         * @return: std::optional<T>, std::nullopt if ringbuffer is empty
+         */
+        constexpr inline std::optional<T> poll_tail(void) {
+            if (is_empty()) return std::nullopt;
+            
+            return take_tail();
         }
         
         /*
          * @brief:  Get current catchable item counts from ringbuffer
          * @return: std::size_t, the current catchable item counts from ringbuffer
          */
-        constexpr inline std::size_t size(void) noexcept {
-            return capacity - m_capacity;
+        constexpr inline std::size_t size(void) const noexcept {
+            return m_size;
         }
         
         /*
          * @brief:  Check if ringbuffer is empty, empty for true, otherwise for false
          * @return: bool
          */
-        constexpr inline bool is_empty(void) noexcept {
-            return m_capacity != capacity ? false : true;
+        constexpr inline bool is_empty(void) const noexcept {
+            return !m_size;
         }
         
         /*
          * @brief:  Check if ringbuffer is full, full for true, otherwise for false
          * @return: bool
          */
-        constexpr inline bool is_full(void) noexcept {
-            return m_capacity ? false : true;
+        constexpr inline bool is_full(void) const noexcept {
+            return m_size == capacity;
+        }
+        
+        /*
+         * @brief:  Pushing item(s) on ringbuffer head in order, only the last capacity item(s) are copied if there are more
+         * @param:  std::span<const T>, the item(s) to push
+         * @return: std::size_t, the number of old and new item(s) overwritten
+         */
+        constexpr inline std::size_t write(std::span<const T> __v) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+            std::size_t overwritten_ { 0 };
+            if (__v.size() > capacity) {
+                overwritten_ = m_size + __v.size() - capacity;
+                empty();
+                __v = __v.last(capacity);
+            } else if (auto const free_ { capacity - m_size }; __v.size() > free_) overwritten_ = __v.size() - free_;
+            
+            for (auto const& v_ : __v) emplace_head(v_);
+            
+            return overwritten_;
         }
         
         /*
-         * @brief: Empty all buffer(s) inside ringbuffer, not free the memory, only reset the ringbuffers pointer position
+         * @brief:  Get item(s) from ringbuffer tail in order, moved into the span and destroyed in their slots
+         * @param:  std::span<T>, where to move the item(s) to, at most its size item(s) are read
+         * @return: std::size_t, the number of item(s) read
+         */
+        constexpr inline std::size_t read(std::span<T> __out) {
+            auto const n_ { std::min(__out.size(), m_size) };
+            for (auto& v_ : __out.first(n_)) v_ = take_tail();
+            
+            return n_;
+        }
+        
+        /*
+         * @brief:  View the stored item(s) in place, oldest first, without copying them
+         * @return: std::array<std::span<const T>, 2>, the item(s) up to the end of the storage and the wrapped ones, the second one is empty if the item(s) do not wrap
+         */
+        constexpr inline std::array<std::span<const T>, 2> peek_contiguous(void) const noexcept {
+            auto const tail_  { index(m_head - m_size) };
+            auto const first_ { std::min(m_size, capacity - tail_) };
+            
+            return { std::span<const T> { m_storage.m_values_ + tail_, first_ }, std::span<const T> { m_storage.m_values_, m_size - first_ } };
+        }
+        
+        /* @brief: Random access iterator over the stored item(s), oldest first, invalidated by any push or catch */
+        template<bool Const>
+        class window_iterator {
+        public:
+            using iterator_concept  = std::random_access_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = T;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = std::conditional_t<Const, const T*, T*>;
+            using reference         = std::conditional_t<Const, const T&, T&>;
+            using owner             = std::conditional_t<Const, const ringbuffer, ringbuffer>;
+            
+            constexpr inline window_iterator(void) noexcept = default;
+            
+            constexpr inline window_iterator(owner* __owner, const std::size_t __offset) noexcept : p_owner { __owner }, m_offset { __offset } {}
+            
+            constexpr inline operator window_iterator<true>(void) const noexcept requires (!Const) { return { p_owner, m_offset }; }
+            
+            constexpr inline reference operator*(void) const noexcept { return *p_owner->slot(p_owner->m_head - p_owner->m_size + m_offset); }
+            
+            constexpr inline pointer operator->(void) const noexcept { return &**this; }
+            
+            constexpr inline reference operator[](const difference_type __n) const noexcept { return *(*this + __n); }
+            
+            constexpr inline window_iterator& operator++(void) noexcept { ++m_offset; return *this; }
+            constexpr inline window_iterator& operator--(void) noexcept { --m_offset; return *this; }
+            constexpr inline window_iterator  operator++(int) noexcept { auto tmp_ { *this }; ++m_offset; return tmp_; }
+            constexpr inline window_iterator  operator--(int) noexcept { auto tmp_ { *this }; --m_offset; return tmp_; }
+            
+            constexpr inline window_iterator& operator+=(const difference_type __n) noexcept { m_offset += __n; return *this; }
+            constexpr inline window_iterator& operator-=(const difference_type __n) noexcept { m_offset -= __n; return *this; }
+            
+            constexpr inline friend window_iterator operator+(window_iterator __it, const difference_type __n) noexcept { return __it += __n; }
+            constexpr inline friend window_iterator operator+(const difference_type __n, window_iterator __it) noexcept { return __it += __n; }
+            constexpr inline friend window_iterator operator-(window_iterator __it, const difference_type __n) noexcept { return __it -= __n; }
+            
+            constexpr inline friend difference_type operator-(const window_iterator& __l, const window_iterator& __r) noexcept {
+                return static_cast<difference_type>(__l.m_offset) - static_cast<difference_type>(__r.m_offset);
+            }
+            
+            constexpr inline bool operator==(const window_iterator& __r) const noexcept { return m_offset == __r.m_offset; }
+            constexpr inline auto operator<=>(const window_iterator& __r) const noexcept { return m_offset <=> __r.m_offset; }
+            
+        private:
+            owner*      p_owner  { nullptr };
+            std::size_t m_offset { 0 };
+        };
+        
+        using iterator       = window_iterator<false>;
+        using const_iterator = window_iterator<true>;
+        
+        constexpr inline iterator       begin(void)       noexcept { return { this, 0 }; }
+        constexpr inline iterator       end(void)         noexcept { return { this, m_size }; }
+        constexpr inline const_iterator begin(void) const noexcept { return { this, 0 }; }
+        constexpr inline const_iterator end(void)   const noexcept { return { this, m_size }; }
+        
+        /* @brief: The i-th oldest stored item */
+        constexpr inline T&       operator[](const std::size_t __i)       noexcept { return *slot(m_head - m_size + __i); }
+        constexpr inline const T& operator[](const std::size_t __i) const noexcept { return *slot(m_head - m_size + __i); }
+        
+        /*
+         * @brief: Empty all buffer(s) inside ringbuffer, destroys the item(s) and resets the ringbuffers pointer position
          */
         constexpr inline void empty(void) noexcept {
-            m_capacity = capacity;
-            m_position = 0;
+            for (; m_size; --m_size) std::destroy_at(slot(m_head - m_size));
+            m_head = 0;
         }
         
     protected:
-        constexpr inline bool is_overwrite(void) noexcept {
-            return (m_capacity ? --m_capacity : 0) ? false : true;
+        constexpr inline static std::size_t index(const std::size_t __position) noexcept {
+            if constexpr (std::has_single_bit(capacity)) return __position & (capacity - 1);
+            else return __position % capacity;
+        }
+        
+        constexpr inline T* slot(const std::size_t __position) noexcept {
+            return &m_storage.m_values_[index(__position)];
+        }
+        
+        constexpr inline const T* slot(const std::size_t __position) const noexcept {
+            return &m_storage.m_values_[index(__position)];
+        }
+        
+        constexpr inline T take_tail(void) {
+            auto* p_ { slot(m_head - m_size) };
+            T v_ { std::move(*p_) };
+            std::destroy_at(p_);
+            --m_size;
+            
+            return v_;
         }
         
     private:
-        T*          p_buffer   { new T[capacity + 1] };
-        std::size_t m_capacity { capacity };
-        std::size_t m_position { 0 };
+        union storage {
+            constexpr inline storage(void) noexcept {}
+            constexpr inline ~storage(void) noexcept {}
+            
+            T m_values_[capacity];
+        };
+        
+        storage     m_storage;
+        std::size_t m_head { 0 };
+        std::size_t m_size { 0 };
+    };
+
+    /*
+     * @brief: SPSC ringbuffer, push_head() from one thread and catch_tail() from another, overwrites the oldest item when full
+     *         - head and tail are monotonic counters on their own cache lines, the producer drops the oldest item by moving the tail
+     *         - capacity + 1 slots, a catch marks its slot while copying, the producer only waits on a marked slot when it has lapped
+     *           the reader during the copy, so a caught item is never torn
+     */
+    template<typename T, const std::size_t capacity, typename Mode>
+        requires (Mode::synchronized)
+    class ringbuffer<T, capacity, Mode> {
+    public:
+        constexpr inline ringbuffer(void) {
+            static_assert(capacity >= 1UL, "ringbuffer capacity < 1");
+        }
+
+        inline ringbuffer &operator=(const ringbuffer&) = delete;
+
+        /*
+         * @brief:  Pushing an new item on ringbuffer head, producer thread only
+         * @param:  U&&, the item, copied or moved into its slot
+         * @return: bool, whether the ringbuffer is full after the push, the next push overwrites the oldest item
+         */
+        template<typename U = T> requires std::is_assignable_v<T&, U&&>
+        inline bool push_head(U&& __v) noexcept {
+            auto const head_ { m_head.load(std::memory_order::relaxed) };
+            if (auto tail_ { m_tail.load(std::memory_order::seq_cst) }; head_ - tail_ == capacity)
+                m_tail.compare_exchange_strong(tail_, tail_ + 1, std::memory_order::seq_cst);
+
+            auto& slot_ { m_slots[head_ % m_slots.size()] };
+            while (slot_.m_reading_.load(std::memory_order::seq_cst)) cpu_relax();
+            slot_.m_value_ = std::forward<U>(__v);
+            m_head.store(head_ + 1, std::memory_order::release);
+
+            return head_ + 1 - m_tail.load(std::memory_order::relaxed) == capacity;
+        }
+
+        /*
+         * @brief:  Get an item from ringbuffer tail, consumer thread only, the default initialized type T if ringbuffer is empty
+         * @return: T, the oldest item which has not been overwritten
+         */
+        inline T catch_tail(void) noexcept {
+            while (true) {
+                auto tail_ { m_tail.load(std::memory_order::acquire) };
+                if (tail_ == m_head.load(std::memory_order::acquire)) return T {};
+
+                auto& slot_ { m_slots[tail_ % m_slots.size()] };
+                slot_.m_reading_.store(true, std::memory_order::seq_cst);
+                if (m_tail.load(std::memory_order::seq_cst) != tail_) {
+                    slot_.m_reading_.store(false, std::memory_order::release);
+                    continue;
+                }
+
+                T v_ { slot_.m_value_ };
+                slot_.m_reading_.store(false, std::memory_order::release);
+                m_tail.compare_exchange_strong(tail_, tail_ + 1, std::memory_order::seq_cst);
+
+                return v_;
+            }
+        }
+
+        /* @brief: Current catchable item counts, a snapshot while the other thread runs */
+        inline std::size_t size(void) const noexcept {
+            auto const tail_ { m_tail.load(std::memory_order::acquire) };
+            return m_head.load(std::memory_order::acquire) - tail_;
+        }
+
+        inline bool is_empty(void) const noexcept { return !size(); }
+
+        inline bool is_full(void) const noexcept { return size() == capacity; }
+
+        /* @brief: Drop every item, consumer thread only */
+        inline void empty(void) noexcept {
+            for (auto tail_ { m_tail.load(std::memory_order::relaxed) };
+                 !m_tail.compare_exchange_weak(tail_, std::max(tail_, m_head.load(std::memory_order::acquire)), std::memory_order::seq_cst);) {}
+        }
+
+    private:
+        struct slot {
+            std::atomic_bool m_reading_ { false };
+            T                m_value_   {};
+        };
+
+        std::array<slot, capacity + 1> m_slots;
+
+        alignas(hardware_destructive_interference_size) std::atomic_size_t m_head { 0 };
+        alignas(hardware_destructive_interference_size) std::atomic_size_t m_tail { 0 };
     };
 }
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include <bit>
+
+#include <cstdint>
+#include <cstddef>
+#include <concepts>
+#include <optional>
+
+#include "../utilities/interference_size.hpp"
+
+namespace ubn
+{
+    /*
+     * @brief: Broadcast policies, what the producer does once the ring is full of items a subscriber has not read yet
+     *         - block_on_slowest:  the producer waits for the slowest subscriber, no subscriber loses an item
+     *         - overwrite_slowest: the producer never waits for a cursor, a subscriber that falls a whole ring behind skips ahead and
+     *                              counts the items it lost
+     */
+    struct block_on_slowest
+    {
+        static constexpr bool overwrite{false};
+    };
+
+    struct overwrite_slowest
+    {
+        static constexpr bool overwrite{true};
+    };
+
+    /*
+     * Single producer, multiple subscriber broadcast channel (1:N) on a ring of sequence numbered slots
+     *  - every subscriber reads every item at its own cursor, items are visited in place and never copied per subscriber
+     *  - block_on_slowest gates the producer on the minimum cursor, rescanned only when the cached minimum says the ring is full
+     *  - overwrite_slowest pins a slot while a subscriber visits it, the producer only waits for pins, never for cursors
+     *  - subscribers join at the current head and must not outlive the channel
+     */
+    template <typename T, typename Policy = block_on_slowest>
+    class broadcast
+    {
+    protected:
+        struct cursor;
+
+    public:
+        class subscriber
+        {
+        public:
+            inline subscriber(subscriber &&other) noexcept : p_channel{std::exchange(other.p_channel, nullptr)}, p_cursor{std::exchange(other.p_cursor, nullptr)}, m_lost{other.m_lost} {}
+
+            inline ~subscriber(void) noexcept
+            {
+                if (p_channel)
+                    p_channel->release(*p_cursor);
+            }
+
+            inline subscriber(const subscriber &) = delete;
+            inline subscriber &operator=(const subscriber &) = delete;
+            inline subscriber &operator=(subscriber &&) = delete;
+
+            /*
+             * @brief:  Visit the next item in its slot, blocks until the producer has published it
+             * @param:  F&&, invocable with const T&, the item is shared with every other subscriber
+             * @return: bool, false once the channel is closed and every published item has been read
+             */
+            template <std::invocable<const T &> F>
+            inline bool consume(F &&f) noexcept { return p_channel->read(*p_cursor, m_lost, std::forward<F>(f), true); }
+
+            template <std::invocable<const T &> F>
+            inline bool try_consume(F &&f) noexcept { return p_channel->read(*p_cursor, m_lost, std::forward<F>(f), false); }
+
+            /* @brief: Copy of the next item, cheap for handle types like cv::Mat that share their buffer */
+            inline std::optional<T> poll(void) noexcept
+            {
+                std::optional<T> tmp_;
+                consume([&tmp_](const T &v) { tmp_.emplace(v); });
+
+                return tmp_;
+            }
+
+            inline std::optional<T> try_poll(void) noexcept
+            {
+                std::optional<T> tmp_;
+                try_consume([&tmp_](const T &v) { tmp_.emplace(v); });
+
+                return tmp_;
+            }
+
+            /* @brief: Items skipped because the producer lapped this subscriber, always 0 with block_on_slowest */
+            inline std::size_t lost(void) const noexcept { return m_lost; }
+
+        protected:
+            friend class broadcast;
+
+            inline explicit subscriber(broadcast *channel, cursor *c) noexcept : p_channel{channel}, p_cursor{c} {}
+
+        private:
+            broadcast *p_channel;
+            cursor *p_cursor;
+            std::size_t m_lost{0};
+        };
+
+        /*
+         * @param: const std::size_t, the number of slots, rounded up to a power of two
+         * @param: const std::size_t, the maximum number of subscribers at the same time
+         */
+        inline explicit broadcast(const std::size_t capacity = 64, const std::size_t max_subscribers = 8)
+            : m_capacity{std::bit_ceil(std::max<std::size_t>(capacity, 1))},
+              m_mask{m_capacity - 1},
+              m_max_subscribers{max_subscribers},
+              m_slots{std::make_unique<slot[]>(m_capacity)},
+              m_cursors{std::make_unique<cursor[]>(max_subscribers)} {}
+
+        inline ~broadcast(void) noexcept
+        {
+            for (auto i{m_published > m_capacity ? m_published - m_capacity : 0}; i != m_published; ++i)
+                m_slots[i & m_mask].get()->~T();
+        }
+
+        inline broadcast(const broadcast &) = delete;
+        inline broadcast &operator=(const broadcast &) = delete;
+
+        /*
+         * @brief:  Join the channel at the current head
+         * @return: std::optional<subscriber>, std::nullopt if max_subscribers are already subscribed
+         */
+        inline std::optional<subscriber> subscribe(void) noexcept
+        {
+            for (std::size_t i{0}; i != m_max_subscribers; ++i)
+            {
+                auto &cursor_{m_cursors[i]};
+                if (cursor_.m_claimed_.test_and_set(std::memory_order::acquire))
+                    continue;
+
+                cursor_.m_next_.store(m_head.load(std::memory_order::seq_cst) & ~m_closed_bit, std::memory_order::seq_cst);
+                std::atomic_thread_fence(std::memory_order::seq_cst);
+                cursor_.m_next_.store(m_head.load(std::memory_order::seq_cst) & ~m_closed_bit, std::memory_order::seq_cst);
+                cursor_.m_next_.notify_one();
+
+                return subscriber{this, &cursor_};
+            }
+
+            return std::nullopt;
+        }
+
+        /*
+         * @brief:  Publish an item to every subscriber, producer thread only
+         * @return: bool, whether the item has been published, false once the channel has been closed
+         */
+        inline bool push(std::convertible_to<T> auto &&v) noexcept
+        {
+            if (m_closed.load(std::memory_order::relaxed))
+                return false;
+            if constexpr (!Policy::overwrite)
+                gate(true);
+
+            publish(std::forward<decltype(v)>(v));
+
+            return true;
+        }
+
+        /*
+         * @brief:  Publish without waiting for the slowest subscriber, same as push() with overwrite_slowest
+         * @return: bool, whether the item has been published
+         */
+        inline bool try_push(std::convertible_to<T> auto &&v) noexcept
+        {
+            if (m_closed.load(std::memory_order::relaxed))
+                return false;
+            if constexpr (!Policy::overwrite)
+                if (!gate(false))
+                    return false;
+
+            publish(std::forward<decltype(v)>(v));
+
+            return true;
+        }
+
+        /*
+         * @brief: Close the channel, pushes fail from now on, subscribers read what has been published and then get false or std::nullopt
+         */
+        inline void close(void) noexcept
+        {
+            m_closed.store(true, std::memory_order::seq_cst);
+            m_head.fetch_or(m_closed_bit, std::memory_order::seq_cst);
+            m_head.notify_all();
+        }
+
+        inline bool closed(void) const noexcept { return m_closed.load(std::memory_order::acquire); }
+
+        inline std::size_t capacity(void) const noexcept { return m_capacity; }
+
+    protected:
+        struct alignas(hardware_destructive_interference_size) slot
+        {
+        public:
+            inline T *get(void) noexcept { return reinterpret_cast<T *>(&m_storage_); }
+
+            std::atomic_size_t m_sequence_{0};
+            std::atomic_uint32_t m_readers_{0};
+
+        private:
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage_;
+        };
+
+        struct alignas(hardware_destructive_interference_size) cursor
+        {
+            std::atomic_size_t m_next_{s_idle};
+            std::atomic_flag m_claimed_ = ATOMIC_FLAG_INIT;
+        };
+
+        template <typename... Args>
+        inline void publish(Args &&...args) noexcept
+        {
+            auto const sequence_{m_published};
+            auto &slot_{m_slots[sequence_ & m_mask]};
+
+            if constexpr (Policy::overwrite)
+            {
+                slot_.m_sequence_.store(0, std::memory_order::seq_cst);
+                for (auto readers_{slot_.m_readers_.load(std::memory_order::seq_cst)}; readers_; readers_ = slot_.m_readers_.load(std::memory_order::seq_cst))
+                    slot_.m_readers_.wait(readers_, std::memory_order::relaxed);
+            }
+
+            if (sequence_ >= m_capacity)
+                slot_.get()->~T();
+            new (slot_.get()) T(std::forward<Args>(args)...);
+            slot_.m_sequence_.store(sequence_ + 1, std::memory_order::release);
+
+            m_published = sequence_ + 1;
+            m_head.store(m_published, std::memory_order::release);
+            m_head.notify_all();
+        }
+
+        /*
+         * @brief:  Wait until the slowest cursor is less than a ring behind the next sequence
+         * @note:   The fence pairs with the one in subscribe(), either a joining cursor is seen or it starts past the published head
+         */
+        inline bool gate(const bool blocking) noexcept
+        {
+            while (m_published - m_gate >= m_capacity)
+            {
+                std::atomic_thread_fence(std::memory_order::seq_cst);
+
+                auto min_{m_published};
+                cursor *slowest_{nullptr};
+                for (std::size_t i{0}; i != m_max_subscribers; ++i)
+                {
+                    if (auto const next_{m_cursors[i].m_next_.load(std::memory_order::acquire)}; next_ < min_)
+                    {
+                        min_ = next_;
+                        slowest_ = &m_cursors[i];
+                    }
+                }
+
+                m_gate = min_;
+                if (m_published - min_ < m_capacity)
+                    break;
+                if (!blocking)
+                    return false;
+                slowest_->m_next_.wait(min_, std::memory_order::acquire);
+            }
+
+            return true;
+        }
+
+        /*
+         * @brief: Read the item at the cursor
+         *         - block_on_slowest: the slot cannot be overwritten before the cursor moves, it is visited directly
+         *         - overwrite_slowest: the slot is pinned and its sequence re-checked, a lapped cursor jumps to the oldest live sequence
+         * @note:  The reader count and the slot sequence are seq_cst on both sides, either the producer sees the pin or the reader sees
+         *         the slot being rewritten
+         */
+        template <typename F>
+        inline bool read(cursor &cursor_, std::size_t &lost_, F &&f, const bool blocking) noexcept
+        {
+            auto next_{cursor_.m_next_.load(std::memory_order::relaxed)};
+            while (true)
+            {
+                auto const raw_{m_head.load(std::memory_order::seq_cst)};
+                auto const head_{raw_ & ~m_closed_bit};
+                if (next_ >= head_)
+                {
+                    if (!blocking || m_closed.load(std::memory_order::seq_cst))
+                        return false;
+                    m_head.wait(raw_, std::memory_order::relaxed);
+                    continue;
+                }
+
+                auto &slot_{m_slots[next_ & m_mask]};
+                if constexpr (Policy::overwrite)
+                {
+                    slot_.m_readers_.fetch_add(1, std::memory_order::seq_cst);
+                    auto const fresh_{slot_.m_sequence_.load(std::memory_order::seq_cst) == next_ + 1};
+                    if (fresh_)
+                        std::invoke(std::forward<F>(f), std::as_const(*slot_.get()));
+                    if (slot_.m_readers_.fetch_sub(1, std::memory_order::release) == 1)
+                        slot_.m_readers_.notify_one();
+
+                    if (!fresh_)
+                    {
+                        auto const now_{m_head.load(std::memory_order::acquire) & ~m_closed_bit};
+                        auto const oldest_{std::max(next_ + 1, now_ > m_capacity ? now_ - m_capacity + 1 : 0)};
+                        lost_ += oldest_ - next_;
+                        cursor_.m_next_.store(next_ = oldest_, std::memory_order::release);
+                        continue;
+                    }
+                }
+                else
+                    std::invoke(std::forward<F>(f), std::as_const(*slot_.get()));
+
+                cursor_.m_next_.store(next_ + 1, std::memory_order::release);
+                if constexpr (!Policy::overwrite)
+                    cursor_.m_next_.notify_one();
+
+                return true;
+            }
+        }
+
+        inline void release(cursor &cursor_) noexcept
+        {
+            cursor_.m_next_.store(s_idle, std::memory_order::release);
+            cursor_.m_next_.notify_one();
+            cursor_.m_claimed_.clear(std::memory_order::release);
+        }
+
+    private:
+        static constexpr std::size_t s_idle{std::numeric_limits<std::size_t>::max()};
+        static constexpr std::size_t m_closed_bit{std::size_t{1} << (std::numeric_limits<std::size_t>::digits - 1)};
+
+        std::size_t const m_capacity;
+        std::size_t const m_mask;
+        std::size_t const m_max_subscribers;
+
+        std::unique_ptr<slot[]> m_slots;
+        std::unique_ptr<cursor[]> m_cursors;
+
+        std::size_t m_published{0};
+        std::size_t m_gate{0};
+        std::atomic_bool m_closed{false};
+
+        alignas(hardware_destructive_interference_size) std::atomic_size_t mutable m_head{0};
+    };
+}
@@ -1,51 +1,257 @@
 #pragma once
 
-#include <queue>
+#include <array>
+#include <vector>
 
 #include <atomic>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
 
+#include <bit>
+
+#include <cstdint>
 #include <cstddef>
 #include <concepts>
 #include <optional>
 
+#include "../utilities/interference_size.hpp"
+
 namespace ubn
 {
-    template <typename T>
+    /*
+     * @brief: Connector modes
+     *         - queued: every item is handed over in order, the producer waits while depth items are pending
+     *         - latest: triple buffer, the producer never waits and the consumer always gets the freshest complete item,
+     *                   older items are dropped and their buffers are written over by later pushes
+     */
+    struct queued
+    {
+        static constexpr bool latest_only{false};
+    };
+
+    struct latest
+    {
+        static constexpr bool latest_only{true};
+    };
+
+    /*
+     * Queued connector on a ring of depth slots, one producer thread and one consumer thread
+     *  - push() waits only while depth items are pending, depth 1 keeps the producer and the consumer in lockstep
+     *  - poll_batch() waits for the first item and takes whatever else is pending up to max_n, e.g. a batched forward pass
+     */
+    template <typename T, typename Mode = queued>
     class connector
     {
     public:
-        inline explicit connector(void) {}
+        /* @param: const std::size_t, the number of items in flight, rounded up to a power of two */
+        inline explicit connector(const std::size_t depth = 1)
+            : m_mask{std::bit_ceil(std::max<std::size_t>(depth, 1)) - 1},
+              m_slots{std::make_unique<slot[]>(m_mask + 1)} {}
 
-        inline ~connector(void) noexcept {}
+        inline ~connector(void) noexcept
+        {
+            for (auto i{m_head.load(std::memory_order::relaxed)}, tail_{m_tail.load(std::memory_order::relaxed)}; i != tail_; ++i)
+                m_slots[i & m_mask].get()->~T();
+        }
 
         inline connector &operator=(const connector &) = delete;
 
         inline void push(std::convertible_to<T> auto &&v) noexcept
         {
-            m_flag.wait(true, std::memory_order::relaxed);
+            auto const tail_{m_tail.load(std::memory_order::relaxed)};
+            for (auto head_{m_head.load(std::memory_order::acquire)}; tail_ - head_ > m_mask; head_ = m_head.load(std::memory_order::acquire))
+                m_head.wait(head_, std::memory_order::acquire);
 
-            m_data.emplace(std::forward<decltype(v)>(v));
+            new (m_slots[tail_ & m_mask].get()) T(std::forward<decltype(v)>(v));
 
-            m_flag.test_and_set(std::memory_order::acquire);
-            m_flag.notify_one();
+            m_tail.store(tail_ + 1, std::memory_order::release);
+            m_tail.notify_one();
         }
 
         inline T poll(void) noexcept
         {
             std::optional<T> tmp_;
-
-            m_flag.wait(false, std::memory_order::relaxed);
-            m_flag.clear(std::memory_order::release);
-            tmp_ = std::move(m_data.front());
-            m_data.pop();
-            m_flag.notify_one();
+            consume([&tmp_](T &&v) { tmp_.emplace(std::move(v)); });
 
             return std::move(*tmp_);
         }
 
+        /*
+         * @brief: Poll the item into an existing object, move-assigned straight from the connector storage
+         */
+        inline void poll(T &out) noexcept
+        {
+            consume([&out](T &&v) { out = std::move(v); });
+        }
+
+        /*
+         * @brief: Poll the item and visit it in place, its slot is handed back to the producer when the visitor returns
+         * @param: F&&, invocable with T&&, may move from the item or only read it
+         */
+        template <std::invocable<T &&> F>
+        inline void consume(F &&f) noexcept
+        {
+            auto const head_{m_head.load(std::memory_order::relaxed)};
+            wait_tail(head_);
+
+            auto *p_{m_slots[head_ & m_mask].get()};
+            std::invoke(std::forward<F>(f), std::move(*p_));
+            p_->~T();
+
+            m_head.store(head_ + 1, std::memory_order::release);
+            m_head.notify_one();
+        }
+
+        /*
+         * @brief:  Poll up to max_n items into an output iterator, waits for the first one only
+         * @return: O, the output iterator past the last polled item
+         */
+        template <std::output_iterator<T> O>
+        inline O poll_batch(O out, const std::size_t max_n) noexcept
+        {
+            if (!max_n)
+                return out;
+
+            auto const head_{m_head.load(std::memory_order::relaxed)};
+            auto const n_{std::min(wait_tail(head_) - head_, max_n)};
+            for (auto i{head_}; i != head_ + n_; ++i)
+            {
+                auto *p_{m_slots[i & m_mask].get()};
+                *out++ = std::move(*p_);
+                p_->~T();
+            }
+
+            m_head.store(head_ + n_, std::memory_order::release);
+            m_head.notify_one();
+
+            return out;
+        }
+
+        inline std::vector<T> poll_batch(const std::size_t max_n)
+        {
+            std::vector<T> batch_;
+            batch_.reserve(std::min(max_n, m_mask + 1));
+            poll_batch(std::back_inserter(batch_), max_n);
+
+            return batch_;
+        }
+
+        inline std::size_t depth(void) const noexcept { return m_mask + 1; }
+
+    protected:
+        struct slot
+        {
+        public:
+            inline T *get(void) noexcept { return reinterpret_cast<T *>(&m_storage_); }
+
+        private:
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage_;
+        };
+
+        /* @brief: Wait until an item past head has been pushed, returns the tail seen */
+        inline std::size_t wait_tail(const std::size_t head_) noexcept
+        {
+            auto tail_{m_tail.load(std::memory_order::acquire)};
+            for (; tail_ == head_; tail_ = m_tail.load(std::memory_order::acquire))
+                m_tail.wait(tail_, std::memory_order::acquire);
+
+            return tail_;
+        }
+
+    private:
+        std::size_t const m_mask;
+        std::unique_ptr<slot[]> m_slots;
+
+        alignas(hardware_destructive_interference_size) std::atomic_size_t m_head{0};
+        alignas(hardware_destructive_interference_size) std::atomic_size_t m_tail{0};
+    };
+
+    /*
+     * Latest value connector on a triple buffer, one producer thread and one consumer thread
+     *  - the producer owns the back buffer, the consumer owns the front buffer, the middle one is exchanged with a single atomic swap
+     *  - push() never waits, poll() waits only until something newer than the last polled item has been pushed
+     *  - T must be default constructible, buffers are reused, so poll(T&) swaps instead of moving to hand back the consumer's old buffer
+     */
+    template <typename T, typename Mode>
+        requires(Mode::latest_only)
+    class connector<T, Mode>
+    {
+    public:
+        inline explicit connector(void) {}
+
+        inline ~connector(void) noexcept {}
+
+        inline connector &operator=(const connector &) = delete;
+
+        /* @brief: Publish an item, assigned over the stale item in the back buffer */
+        inline void push(std::convertible_to<T> auto &&v) noexcept
+        {
+            write([&v](T &back_) { back_ = std::forward<decltype(v)>(v); });
+        }
+
+        /*
+         * @brief: Fill the back buffer in place and publish it, e.g. cv::Mat::copyTo or cv::VideoCapture::read into the stale frame
+         * @param: F&&, invocable with T&, the buffer still holds an item dropped earlier
+         */
+        template <std::invocable<T &> F>
+        inline void write(F &&f) noexcept
+        {
+            std::invoke(std::forward<F>(f), m_buffers[m_back].m_value_);
+            m_back = m_middle.exchange(m_back | m_fresh_bit, std::memory_order::acq_rel) & m_index_mask;
+            m_middle.notify_one();
+        }
+
+        inline T poll(void) noexcept
+        {
+            return std::move(front());
+        }
+
+        inline void poll(T &out) noexcept
+        {
+            using std::swap;
+            swap(out, front());
+        }
+
+        /* @brief: Visit the freshest item in the front buffer, it stays there until the next poll */
+        template <std::invocable<T &&> F>
+        inline void consume(F &&f) noexcept
+        {
+            std::invoke(std::forward<F>(f), std::move(front()));
+        }
+
+        /* @brief: Whether an item newer than the last polled one is waiting */
+        inline bool fresh(void) const noexcept { return m_middle.load(std::memory_order::acquire) & m_fresh_bit; }
+
+    protected:
+        inline T &front(void) noexcept
+        {
+            auto middle_{m_middle.load(std::memory_order::acquire)};
+            while (!(middle_ & m_fresh_bit))
+            {
+                m_middle.wait(middle_, std::memory_order::acquire);
+                middle_ = m_middle.load(std::memory_order::acquire);
+            }
+            m_front = m_middle.exchange(m_front, std::memory_order::acq_rel) & m_index_mask;
+
+            return m_buffers[m_front].m_value_;
+        }
+
     private:
-        std::queue<T> m_data;
+        struct alignas(hardware_destructive_interference_size) buffer
+        {
+            T m_value_{};
+        };
+
+        static constexpr std::uint32_t m_index_mask{0b011};
+        static constexpr std::uint32_t m_fresh_bit{0b100};
+
+        std::array<buffer, 3> m_buffers;
 
-        alignas(2 * sizeof(std::max_align_t)) mutable std::atomic_flag m_flag{ATOMIC_FLAG_INIT};
+        alignas(hardware_destructive_interference_size) std::uint32_t m_back{0};
+        alignas(hardware_destructive_interference_size) std::uint32_t m_front{2};
+        alignas(hardware_destructive_interference_size) mutable std::atomic<std::uint32_t> m_middle{1};
     };
 }
@@ -0,0 +1,181 @@
+/*
+ * @name: thread_pool.hpp
+ * @namespace: ubn
+ * @class: thread_pool
+ * @brief: Work-stealing thread pool, per-worker Chase-Lev deques plus a global injection queue
+ * @author Unbinilium
+ * @version 1.0.0
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <future>
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include <cstdint>
+#include <cstddef>
+
+#include "../queue/atomic_linked_queue.hpp"
+#include "../queue/atomic_ws_deque.hpp"
+#include "../utilities/interference_size.hpp"
+
+namespace ubn {
+    class thread_pool {
+    public:
+        /*
+         * @brief: Start the workers
+         * @param: const std::size_t, the number of worker threads, at least 1
+         */
+        inline explicit thread_pool(const std::size_t workers = std::thread::hardware_concurrency()) {
+            auto const n_ { workers ? workers : 1 };
+            for (std::size_t i { 0 }; i != n_; ++i) m_deques.push_back(std::make_unique<ws_deque<task*>>());
+            for (std::size_t i { 0 }; i != n_; ++i) m_workers.emplace_back(&thread_pool::work, this, i);
+        }
+
+        /* @brief: Run every task already submitted, then join the workers */
+        inline ~thread_pool(void) noexcept {
+            m_stop.store(true, std::memory_order::release);
+            m_epoch.fetch_add(1, std::memory_order::seq_cst);
+            m_epoch.notify_all();
+            for (auto& worker : m_workers) worker.join();
+        }
+
+        inline thread_pool           (const thread_pool&) = delete;
+        inline thread_pool &operator=(const thread_pool&) = delete;
+
+        /*
+         * @brief:  Submit a callable, tasks submitted from a worker go to its own deque, others to the injection queue
+         * @param:  F&&, Args&&..., the callable and its arguments, both are decay-copied into the task
+         * @return: std::future, the result or the exception of the callable
+         */
+        template <typename F, typename... Args>
+        inline auto submit(F&& f, Args&&... args) {
+            using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+
+            auto* job_    { new job<R>(std::packaged_task<R()>(
+                [f_ = std::forward<F>(f), ...args_ = std::forward<Args>(args)]() mutable -> R { return std::invoke(std::move(f_), std::move(args_)...); }
+            )) };
+            auto  future_ { job_->m_task_.get_future() };
+            enqueue(job_);
+
+            return future_;
+        }
+
+        /*
+         * @brief:  Run one pending task on the calling thread, lets a thread waiting on a future help instead of blocking a worker
+         * @return: bool, whether a task has been run
+         */
+        inline bool run_one(void) noexcept {
+            auto const& worker_ { local_worker() };
+            auto*       task_   { find(worker_.p_pool == this ? worker_.m_index : m_deques.size()) };
+            if (!task_) return false;
+
+            task_->run();
+            delete task_;
+
+            return true;
+        }
+
+        inline std::size_t size(void) const noexcept { return m_workers.size(); }
+
+        /* @brief: Process wide pool with one worker per hardware thread, shared instead of spawning threads per call site */
+        inline static thread_pool& shared(void) {
+            static thread_pool s_pool;
+            return s_pool;
+        }
+
+    protected:
+        struct task {
+            virtual      ~task(void) = default;
+            virtual void run (void) noexcept = 0;
+        };
+
+        template <typename R>
+        struct job final : task {
+            inline explicit job(std::packaged_task<R()>&& t) : m_task_ { std::move(t) } {}
+            inline void run(void) noexcept override { m_task_(); }
+
+            std::packaged_task<R()> m_task_;
+        };
+
+        struct worker {
+            thread_pool* p_pool  { nullptr };
+            std::size_t  m_index { 0 };
+        };
+
+        inline static worker& local_worker(void) noexcept {
+            static thread_local worker s_worker;
+            return s_worker;
+        }
+
+        inline void enqueue(task* task_) {
+            if (auto const& worker_ { local_worker() }; worker_.p_pool == this) m_deques[worker_.m_index]->push(task_);
+            else                                                                m_injection.push(task_);
+
+            m_epoch.fetch_add(1, std::memory_order::seq_cst);
+            if (m_sleeping.load(std::memory_order::seq_cst)) m_epoch.notify_one();
+        }
+
+        /* @brief: Own deque first (self is out of range for non-worker threads), then the injection queue, then steal starting from a random victim */
+        inline task* find(const std::size_t self) noexcept {
+            if (self < m_deques.size()) if (auto task_ { m_deques[self]->pop() }; task_.has_value()) return *task_;
+            if (auto task_ { m_injection.try_poll() }; task_.has_value())                             return *task_;
+
+            static thread_local std::uint32_t s_seed { static_cast<std::uint32_t>(self * 2654435761u + 1) };
+            s_seed ^= s_seed << 13; s_seed ^= s_seed >> 17; s_seed ^= s_seed << 5;
+
+            auto const n_ { m_deques.size() };
+            for (std::size_t i { 0 }; i != n_; ++i) {
+                auto const victim_ { (s_seed + i) % n_ };
+                if (victim_ == self) continue;
+                if (auto task_ { m_deques[victim_]->steal() }; task_.has_value()) return *task_;
+            }
+
+            return nullptr;
+        }
+
+        /* @brief: Worker loop, parks on the submit epoch with std::atomic::wait once there is nothing to run or steal */
+        inline void work(const std::size_t self) noexcept {
+            local_worker() = { this, self };
+
+            auto const run_ { [](task* task_) { task_->run(); delete task_; } };
+            while (true) {
+                if (auto* task_ { find(self) }) {
+                    run_(task_);
+                    continue;
+                }
+
+                auto const epoch_ { m_epoch.load(std::memory_order::acquire) };
+                m_sleeping.fetch_add(1, std::memory_order::seq_cst);
+                if (auto* task_ { find(self) }) {
+                    m_sleeping.fetch_sub(1, std::memory_order::relaxed);
+                    run_(task_);
+                    continue;
+                }
+                if (m_stop.load(std::memory_order::acquire)) {
+                    m_sleeping.fetch_sub(1, std::memory_order::relaxed);
+                    break;
+                }
+                m_epoch.wait(epoch_, std::memory_order::acquire);
+                m_sleeping.fetch_sub(1, std::memory_order::relaxed);
+            }
+        }
+
+    private:
+        std::vector<std::unique_ptr<ws_deque<task*>>> m_deques;
+        atomic_linked::queue<task*>                   m_injection;
+        std::vector<std::thread>                      m_workers;
+
+        alignas(hardware_destructive_interference_size) std::atomic_uint32_t mutable m_epoch    { 0 };
+        alignas(hardware_destructive_interference_size) std::atomic_size_t   mutable m_sleeping { 0 };
+                                                        std::atomic_bool             m_stop     { false };
+    };
+}
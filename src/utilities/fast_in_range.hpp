@@ -1,7 +1,8 @@
 /*
  Note:
     - CPU side multi-threading cv::inRange() accelerate
-    - currently no worker implementation, not stable, substantial improvement on large frames
+    - row blocks run on the shared ubn::thread_pool, the calling thread takes the first block and helps with pending tasks while waiting
+    - substantial improvement on large frames
  */
 
 #ifndef FAST_IN_RANGE_HPP
@@ -9,10 +10,14 @@
 
 #include <cstdint>
 #include <future>
+#include <vector>
+#include <algorithm>
 
 #include <opencv2/core.hpp>
 #include <opencv2/core/mat.hpp>
 
+#include "../thread_pool/thread_pool.hpp"
+
 namespace ubn {
     class fastInRange {
     private:
@@ -20,22 +25,37 @@ namespace ubn {
         const int b_h;
         cv::Mat   out;
         
-        inline void Impl(cv::Mat& input, cv::Scalar&& l, cv::Scalar&& h, cv::Mat& output, const int h_s) {
-            const int h_e { h_s + b_h };
-            
-            std::future<void> f;
-            if (--thr) { f = std::async(std::launch::async, &fastInRange::Impl, this, std::ref(input), l, h, std::ref(output), std::ref(h_e)); }
-            cv::inRange(input.rowRange(h_s, h_e), l, h, output.rowRange(h_s, h_e));
-            if (thr) { f.get(); }
+        inline void Impl(cv::Mat& input, const cv::Scalar& l, const cv::Scalar& h, cv::Mat& output) {
+            auto& pool { thread_pool::shared() };
+
+            std::vector<std::future<void>> f;
+            for (uint i = 1; i < thr; ++i) {
+                const int h_s { static_cast<int>(i) * b_h };
+                const int h_e { i + 1 == thr ? input.rows : h_s + b_h };
+                if (h_s == h_e) continue;
+                f.push_back(pool.submit([&input, &l, &h, &output, h_s, h_e] {
+                    cv::inRange(input.rowRange(h_s, h_e), l, h, output.rowRange(h_s, h_e));
+                }));
+            }
+
+            const int h_e { thr > 1 ? b_h : input.rows };
+            if (h_e) { cv::inRange(input.rowRange(0, h_e), l, h, output.rowRange(0, h_e)); }
+
+            for (auto& i : f) {
+                while (i.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    if (!pool.run_one()) { std::this_thread::yield(); }
+                }
+                i.get();
+            }
         }
         
     public:
         inline fastInRange(cv::Mat& input, cv::Scalar&& l, cv::Scalar&& h, cv::Mat& output) :
-        thr { std::thread::hardware_concurrency() },
+        thr { static_cast<uint>(std::max<std::size_t>(1, thread_pool::shared().size())) },
         b_h { static_cast<int>(std::floor(input.rows / thr)) },
         out { cv::Mat(input.size(), CV_8UC1) }
         {
-            this->Impl(input, std::move(l), std::move(h), out, 0);
+            this->Impl(input, l, h, out);
             out.copyTo(output);
         }
     };
@@ -0,0 +1,29 @@
+/*
+ Note:
+    - single definition of the cache line sizes used for padding across ubn headers
+    - prefers the std values when the library provides them, GCC warns about their use in headers because they
+      follow -mtune, the value is taken once here so every header agrees on it within a build
+    - falls back to 64 bytes which matches x86-64 and most aarch64 cores
+ */
+
+#pragma once
+
+#include <new>
+#include <cstddef>
+
+namespace ubn {
+#ifdef __cpp_lib_hardware_interference_size
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+    inline constexpr std::size_t hardware_constructive_interference_size { std::hardware_constructive_interference_size };
+    inline constexpr std::size_t hardware_destructive_interference_size  { std::hardware_destructive_interference_size };
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+    inline constexpr std::size_t hardware_constructive_interference_size { 64 };
+    inline constexpr std::size_t hardware_destructive_interference_size  { 64 };
+#endif
+}
@@ -0,0 +1,108 @@
+/*
+ Note:
+    - wait strategies for code blocking on an atomic value, selected at compile time
+    - each strategy blocks while the atomic still holds the old value, and pairs it with the matching notify
+        - spin_wait:       busy spin with the cpu pause hint, never sleeps, notify is a no-op
+        - spin_then_park:  spin up to N times, then sleep in std::atomic::wait (futex on linux)
+        - park_wait:       go straight to std::atomic::wait
+    - backoff is the spin phase on its own, for callers that park on something else than the atomic they spin on
+    - wait_until is the timed form for poll_until and friends, std::atomic::wait has no timed overload so it sleeps in bounded steps
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace ubn {
+    /* @brief: Hint the cpu that the caller is spinning, keeps the sibling hyper-thread and the memory bus less busy */
+    inline void cpu_relax(void) noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    /*
+     * @brief: Bounded exponential backoff, pause 1, 2, 4 .. 64 times per round for Spins rounds, then yield for Yields rounds
+     * @usage: for (ubn::backoff<> b; !ready(); ) if (!b.spin()) { park(); break; }
+     */
+    template <std::size_t Spins = 16, std::size_t Yields = 4>
+    struct backoff {
+        /* @return: bool, false once the budget is spent and the caller should park */
+        inline bool spin(void) noexcept {
+            if (m_round < Spins) {
+                for (std::size_t i { std::size_t { 1 } << std::min<std::size_t>(m_round, 6) }; i; --i) cpu_relax();
+            } else if (m_round < Spins + Yields) {
+                std::this_thread::yield();
+            } else return false;
+            ++m_round;
+
+            return true;
+        }
+
+        std::size_t m_round { 0 };
+    };
+
+    /*
+     * @brief:  Wait while the atomic holds old or until the deadline, backs off first, then sleeps 1us, 2us .. 1ms between checks,
+     *          never past the deadline, the caller re-checks its condition on return like after any other wait
+     * @return: bool, false if the deadline has been reached and the atomic still holds old
+     */
+    template <typename A, typename Clock, typename Duration>
+    inline bool wait_until(const A& a, const typename A::value_type old, const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+        backoff<> backoff_;
+        std::chrono::microseconds sleep_ { 1 };
+        while (a.load(std::memory_order::relaxed) == old) {
+            auto const now_ { Clock::now() };
+            if (now_ >= deadline) return false;
+            if (backoff_.spin()) continue;
+
+            std::this_thread::sleep_for(std::min(sleep_, std::chrono::ceil<std::chrono::microseconds>(deadline - now_)));
+            sleep_ = std::min(sleep_ * 2, std::chrono::microseconds { 1000 });
+        }
+
+        return true;
+    }
+
+    struct spin_wait {
+        template <typename A>
+        inline static void wait(const A& a, const typename A::value_type old) noexcept {
+            while (a.load(std::memory_order::relaxed) == old) cpu_relax();
+        }
+
+        template <typename A>
+        inline static void notify(A&) noexcept {}
+    };
+
+    template <std::size_t Spins = 128>
+    struct spin_then_park {
+        template <typename A>
+        inline static void wait(const A& a, const typename A::value_type old) noexcept {
+            for (std::size_t i { 0 }; i != Spins; ++i) {
+                if (a.load(std::memory_order::relaxed) != old) return;
+                cpu_relax();
+            }
+            a.wait(old, std::memory_order::relaxed);
+        }
+
+        template <typename A>
+        inline static void notify(A& a) noexcept { a.notify_all(); }
+    };
+
+    struct park_wait {
+        template <typename A>
+        inline static void wait(const A& a, const typename A::value_type old) noexcept { a.wait(old, std::memory_order::relaxed); }
+
+        template <typename A>
+        inline static void notify(A& a) noexcept { a.notify_all(); }
+    };
+}